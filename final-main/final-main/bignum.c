@@ -0,0 +1,499 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "value.h"
+#include "linkedlist.h"
+#include "talloc.h"
+
+#ifndef _BIGNUM
+#define _BIGNUM
+
+// Integers are fixnums (or boxed INT_TYPE Values) as long as they fit in 64
+// bits; arithmetic on them checks for overflow with the compiler's
+// __builtin_*_overflow, which compiles to the processor's overflow flag. Only
+// when that fails does it fall back to the BIGNUM_TYPE code below, which works
+// on magnitudes stored as base 2^32 digits, least significant first.
+
+// Below this many digits, multiplying the schoolbook way is faster than
+// splitting the operands Karatsuba style.
+#define KARATSUBA_THRESHOLD 32
+
+// Decimal digits per base 10^9 chunk when converting to and from strings.
+#define CHUNK_DIGITS 9
+#define CHUNK_BASE 1000000000u
+
+// Magnitude
+// A view of an integer's digits, whether they belong to a Bignum or were
+// unpacked from a 64-bit integer into a buffer on the stack.
+typedef struct Magnitude {
+    bool negative;
+    size_t length;
+    const uint32_t *digits;
+} Magnitude;
+
+// scratchAlloc
+// params: count - a number of digits
+// returns: a pointer to uninitialized room for that many digits, to be given back with free
+// exits the program if the system is out of memory
+uint32_t *scratchAlloc(size_t count) {
+    uint32_t *scratch = malloc((count > 0 ? count : 1) * sizeof(uint32_t));
+    if (scratch == NULL) {
+        printf("Error: out of memory\n");
+        texit(1);
+    }
+    return scratch;
+}
+
+// textAlloc
+// params: size - a number of characters
+// returns: a pointer to room for that many characters, to be given back with free
+// exits the program if the system is out of memory
+char *textAlloc(size_t size) {
+    char *text = malloc(size);
+    if (text == NULL) {
+        printf("Error: out of memory\n");
+        texit(1);
+    }
+    return text;
+}
+
+// magnitudeOf
+// params: value - a pointer to an INT_TYPE or BIGNUM_TYPE Value; buffer - room for two digits
+// returns: the value's sign and digits; a 64-bit integer's digits are unpacked into buffer
+Magnitude magnitudeOf(Value *value, uint32_t *buffer) {
+    Magnitude magnitude;
+    if (typeOf(value) == BIGNUM_TYPE) {
+        magnitude.negative = value -> b -> negative;
+        magnitude.length = value -> b -> length;
+        magnitude.digits = value -> b -> digits;
+        return magnitude;
+    }
+    int64_t number = intOf(value);
+    // negate as unsigned, so the most negative integer doesn't overflow
+    uint64_t absolute = number < 0 ? -(uint64_t)number : (uint64_t)number;
+    buffer[0] = (uint32_t)absolute;
+    buffer[1] = (uint32_t)(absolute >> 32);
+    magnitude.negative = number < 0;
+    magnitude.length = buffer[1] != 0 ? 2 : buffer[0] != 0 ? 1 : 0;
+    magnitude.digits = buffer;
+    return magnitude;
+}
+
+// trimmedLength
+// params: digits - a pointer to digits; length - how many there are
+// returns: the length without any leading zero digits
+size_t trimmedLength(const uint32_t *digits, size_t length) {
+    while (length > 0 && digits[length - 1] == 0) {
+        length--;
+    }
+    return length;
+}
+
+// makeInteger
+// params: negative - the sign; digits - a pointer to a magnitude; length - its number of digits
+// returns: a Value holding the integer: from makeInt if it fits in 64 bits, and a new BIGNUM_TYPE Value otherwise
+// the digits are copied into a payload of the new Value (see tallocPayload), so they may live in scratch memory
+Value *makeInteger(bool negative, const uint32_t *digits, size_t length) {
+    length = trimmedLength(digits, length);
+    if (length <= 2) {
+        uint64_t absolute = length == 0 ? 0 : digits[0];
+        if (length == 2) {
+            absolute |= (uint64_t)digits[1] << 32;
+        }
+        if (!negative && absolute <= (uint64_t)INT64_MAX) {
+            return makeInt((int64_t)absolute);
+        }
+        if (negative && absolute <= (uint64_t)INT64_MAX + 1) {
+            return makeInt((int64_t)(0 - absolute));
+        }
+    }
+    Value *result = talloc(sizeof(Value));
+    Bignum *big = tallocPayload(result, sizeof(Bignum) + length * sizeof(uint32_t));
+    big -> negative = negative;
+    big -> length = (uint32_t)length;
+    memcpy(big -> digits, digits, length * sizeof(uint32_t));
+    result -> type = BIGNUM_TYPE;
+    result -> b = big;
+    return result;
+}
+
+// compareDigits
+// params: a, b - pointers to magnitudes with no leading zeros; aLength, bLength - their numbers of digits
+// returns: a negative number, zero or a positive number as a is less than, equal to or greater than b
+int compareDigits(const uint32_t *a, size_t aLength, const uint32_t *b, size_t bLength) {
+    if (aLength != bLength) {
+        return aLength < bLength ? -1 : 1;
+    }
+    for (size_t i = aLength; i > 0; i--) {
+        if (a[i - 1] != b[i - 1]) {
+            return a[i - 1] < b[i - 1] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// addDigits
+// params: result - room for max(aLength, bLength) + 1 digits; a, b - pointers to magnitudes; aLength, bLength -
+//         their numbers of digits
+// returns: Nothing
+// result may be the same as a
+void addDigits(uint32_t *result, const uint32_t *a, size_t aLength, const uint32_t *b, size_t bLength) {
+    if (aLength < bLength) {
+        const uint32_t *swap = a;
+        a = b;
+        b = swap;
+        size_t swapLength = aLength;
+        aLength = bLength;
+        bLength = swapLength;
+    }
+    uint64_t carry = 0;
+    for (size_t i = 0; i < aLength; i++) {
+        carry += (uint64_t)a[i] + (i < bLength ? b[i] : 0);
+        result[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    result[aLength] = (uint32_t)carry;
+}
+
+// subtractDigits
+// params: result - room for aLength digits; a, b - pointers to magnitudes where a is at least b; aLength, bLength -
+//         their numbers of digits
+// returns: Nothing
+// result may be the same as a
+void subtractDigits(uint32_t *result, const uint32_t *a, size_t aLength, const uint32_t *b, size_t bLength) {
+    int64_t borrow = 0;
+    for (size_t i = 0; i < aLength; i++) {
+        borrow += (int64_t)a[i] - (i < bLength ? b[i] : 0);
+        result[i] = (uint32_t)borrow;
+        borrow = borrow < 0 ? -1 : 0;
+    }
+}
+
+// schoolbookMultiply
+// params: result - room for aLength + bLength digits; a, b - pointers to magnitudes; aLength, bLength - their
+//         numbers of digits
+// returns: Nothing
+void schoolbookMultiply(uint32_t *result, const uint32_t *a, size_t aLength, const uint32_t *b, size_t bLength) {
+    memset(result, 0, (aLength + bLength) * sizeof(uint32_t));
+    for (size_t i = 0; i < aLength; i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < bLength; j++) {
+            carry += (uint64_t)a[i] * b[j] + result[i + j];
+            result[i + j] = (uint32_t)carry;
+            carry >>= 32;
+        }
+        result[i + bLength] = (uint32_t)carry;
+    }
+}
+
+// karatsubaScratch
+// params: length - the number of digits in each operand of karatsubaMultiply
+// returns: the number of scratch digits karatsubaMultiply needs for operands that long
+size_t karatsubaScratch(size_t length) {
+    size_t total = 0;
+    while (length >= KARATSUBA_THRESHOLD) {
+        length = length - length / 2 + 1;
+        total += 4 * length;
+    }
+    return total;
+}
+
+// karatsubaMultiply
+// params: result - room for 2 * length digits; a, b - pointers to magnitudes of length digits each; scratch - room
+//         for karatsubaScratch(length) digits
+// returns: Nothing
+// splits each operand into a low half of half digits and a high half, and gets by with three half-size products:
+// low * low, high * high, and (low + high) * (low + high), from which the middle term is recovered by subtraction
+void karatsubaMultiply(uint32_t *result, const uint32_t *a, const uint32_t *b, size_t length, uint32_t *scratch) {
+    if (length < KARATSUBA_THRESHOLD) {
+        schoolbookMultiply(result, a, length, b, length);
+        return;
+    }
+    size_t half = length / 2;
+    size_t high = length - half;
+    size_t sumLength = high + 1;
+
+    uint32_t *aSum = scratch;
+    uint32_t *bSum = aSum + sumLength;
+    uint32_t *middle = bSum + sumLength;
+    uint32_t *rest = middle + 2 * sumLength;
+
+    // low * low goes in the bottom of result, and high * high in the top; they don't overlap
+    karatsubaMultiply(result, a, b, half, rest);
+    karatsubaMultiply(result + 2 * half, a + half, b + half, high, rest);
+
+    addDigits(aSum, a, half, a + half, high);
+    addDigits(bSum, b, half, b + half, high);
+    karatsubaMultiply(middle, aSum, bSum, sumLength, rest);
+
+    size_t middleLength = trimmedLength(middle, 2 * sumLength);
+    subtractDigits(middle, middle, middleLength, result, 2 * half);
+    subtractDigits(middle, middle, middleLength, result + 2 * half, 2 * (length - half));
+
+    // add the middle term in at digit half, carrying as far as it goes
+    uint64_t carry = 0;
+    size_t i = 0;
+    for (; i < middleLength; i++) {
+        carry += (uint64_t)result[half + i] + middle[i];
+        result[half + i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    for (; carry != 0 && half + i < 2 * length; i++) {
+        carry += result[half + i];
+        result[half + i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+}
+
+// multiplyDigits
+// params: result - room for aLength + bLength digits; a, b - pointers to magnitudes; aLength, bLength - their
+//         numbers of digits
+// returns: Nothing
+// uses the schoolbook method for short operands; otherwise the longer operand is cut into pieces as long as the
+// shorter one, and each piece is multiplied Karatsuba style
+void multiplyDigits(uint32_t *result, const uint32_t *a, size_t aLength, const uint32_t *b, size_t bLength) {
+    if (aLength < bLength) {
+        const uint32_t *swap = a;
+        a = b;
+        b = swap;
+        size_t swapLength = aLength;
+        aLength = bLength;
+        bLength = swapLength;
+    }
+    if (bLength < KARATSUBA_THRESHOLD) {
+        schoolbookMultiply(result, a, aLength, b, bLength);
+        return;
+    }
+
+    uint32_t *piece = scratchAlloc(bLength + 2 * bLength + karatsubaScratch(bLength));
+    uint32_t *product = piece + bLength;
+    uint32_t *scratch = product + 2 * bLength;
+    memset(result, 0, (aLength + bLength) * sizeof(uint32_t));
+    for (size_t offset = 0; offset < aLength; offset += bLength) {
+        size_t pieceLength = aLength - offset < bLength ? aLength - offset : bLength;
+        memcpy(piece, a + offset, pieceLength * sizeof(uint32_t));
+        memset(piece + pieceLength, 0, (bLength - pieceLength) * sizeof(uint32_t));
+        karatsubaMultiply(product, piece, b, bLength, scratch);
+
+        // only the first pieceLength + bLength digits of the product can be nonzero
+        uint64_t carry = 0;
+        for (size_t i = 0; i < pieceLength + bLength; i++) {
+            carry += (uint64_t)result[offset + i] + product[i];
+            result[offset + i] = (uint32_t)carry;
+            carry >>= 32;
+        }
+    }
+    free(piece);
+}
+
+// addSigned
+// params: x, y - integers; negateY - whether to add -y instead of y
+// returns: a Value holding x + y (or x - y)
+Value *addSigned(Magnitude x, Magnitude y, bool negateY) {
+    bool yNegative = y.negative != negateY;
+    size_t length = (x.length > y.length ? x.length : y.length) + 1;
+    uint32_t *sum = scratchAlloc(length);
+    bool negative;
+    if (x.negative == yNegative) {
+        addDigits(sum, x.digits, x.length, y.digits, y.length);
+        negative = x.negative;
+    } else if (compareDigits(x.digits, x.length, y.digits, y.length) >= 0) {
+        subtractDigits(sum, x.digits, x.length, y.digits, y.length);
+        length = x.length;
+        negative = x.negative;
+    } else {
+        subtractDigits(sum, y.digits, y.length, x.digits, x.length);
+        length = y.length;
+        negative = yNegative;
+    }
+    Value *result = makeInteger(negative, sum, length);
+    free(sum);
+    return result;
+}
+
+// integerAdd
+// params: a, b - pointers to INT_TYPE or BIGNUM_TYPE Values
+// returns: a Value holding a + b
+Value *integerAdd(Value *a, Value *b) {
+    int64_t sum;
+    if (typeOf(a) == INT_TYPE && typeOf(b) == INT_TYPE && !__builtin_add_overflow(intOf(a), intOf(b), &sum)) {
+        return makeInt(sum);
+    }
+    uint32_t aBuffer[2], bBuffer[2];
+    return addSigned(magnitudeOf(a, aBuffer), magnitudeOf(b, bBuffer), false);
+}
+
+// integerSubtract
+// params: a, b - pointers to INT_TYPE or BIGNUM_TYPE Values
+// returns: a Value holding a - b
+Value *integerSubtract(Value *a, Value *b) {
+    int64_t difference;
+    if (typeOf(a) == INT_TYPE && typeOf(b) == INT_TYPE && !__builtin_sub_overflow(intOf(a), intOf(b), &difference)) {
+        return makeInt(difference);
+    }
+    uint32_t aBuffer[2], bBuffer[2];
+    return addSigned(magnitudeOf(a, aBuffer), magnitudeOf(b, bBuffer), true);
+}
+
+// integerMultiply
+// params: a, b - pointers to INT_TYPE or BIGNUM_TYPE Values
+// returns: a Value holding a * b
+Value *integerMultiply(Value *a, Value *b) {
+    int64_t product;
+    if (typeOf(a) == INT_TYPE && typeOf(b) == INT_TYPE && !__builtin_mul_overflow(intOf(a), intOf(b), &product)) {
+        return makeInt(product);
+    }
+    uint32_t aBuffer[2], bBuffer[2];
+    Magnitude x = magnitudeOf(a, aBuffer);
+    Magnitude y = magnitudeOf(b, bBuffer);
+    uint32_t *digits = scratchAlloc(x.length + y.length);
+    multiplyDigits(digits, x.digits, x.length, y.digits, y.length);
+    Value *result = makeInteger(x.negative != y.negative, digits, x.length + y.length);
+    free(digits);
+    return result;
+}
+
+// integerCompare
+// params: a, b - pointers to INT_TYPE or BIGNUM_TYPE Values
+// returns: a negative number, zero or a positive number as a is less than, equal to or greater than b
+int integerCompare(Value *a, Value *b) {
+    if (typeOf(a) == INT_TYPE && typeOf(b) == INT_TYPE) {
+        int64_t x = intOf(a);
+        int64_t y = intOf(b);
+        return x < y ? -1 : x > y ? 1 : 0;
+    }
+    uint32_t aBuffer[2], bBuffer[2];
+    Magnitude x = magnitudeOf(a, aBuffer);
+    Magnitude y = magnitudeOf(b, bBuffer);
+    if (x.negative != y.negative) {
+        return x.negative ? -1 : 1;
+    }
+    int order = compareDigits(x.digits, x.length, y.digits, y.length);
+    return x.negative ? -order : order;
+}
+
+// integerFromUnsigned
+// params: number - an unsigned 64-bit integer
+// returns: a Value holding it, which is a BIGNUM_TYPE only if it is too big for an int64_t
+Value *integerFromUnsigned(uint64_t number) {
+    uint32_t digits[2] = {(uint32_t)number, (uint32_t)(number >> 32)};
+    return makeInteger(false, digits, 2);
+}
+
+// integerToUnsigned
+// params: value - a pointer to an INT_TYPE or BIGNUM_TYPE Value; number - where to store it
+// returns: true if the integer is from 0 to 2^64 - 1 and was stored, false otherwise
+bool integerToUnsigned(Value *value, uint64_t *number) {
+    uint32_t buffer[2];
+    Magnitude magnitude = magnitudeOf(value, buffer);
+    if (magnitude.negative || magnitude.length > 2) {
+        return false;
+    }
+    *number = 0;
+    for (size_t i = magnitude.length; i > 0; i--) {
+        *number = (*number << 32) | magnitude.digits[i - 1];
+    }
+    return true;
+}
+
+// integerToDouble
+// params: value - a pointer to an INT_TYPE or BIGNUM_TYPE Value
+// returns: the nearest double to the integer
+double integerToDouble(Value *value) {
+    if (typeOf(value) == INT_TYPE) {
+        return (double)intOf(value);
+    }
+    double result = 0;
+    for (size_t i = value -> b -> length; i > 0; i--) {
+        result = result * 4294967296.0 + value -> b -> digits[i - 1];
+    }
+    return value -> b -> negative ? -result : result;
+}
+
+// parseInteger
+// params: text - a string of decimal digits, optionally starting with a sign
+// returns: a Value holding the integer it spells, however big
+Value *parseInteger(const char *text) {
+    bool negative = *text == '-';
+    if (*text == '-' || *text == '+') {
+        text++;
+    }
+    size_t count = strlen(text);
+    if (count <= 18) {
+        // too few digits to overflow 64 bits
+        int64_t number = 0;
+        for (size_t i = 0; i < count; i++) {
+            number = number * 10 + (text[i] - '0');
+        }
+        return makeInt(negative ? -number : number);
+    }
+    // each base 10^9 chunk adds less than one base 2^32 digit
+    size_t capacity = count / CHUNK_DIGITS + 2;
+    uint32_t *digits = scratchAlloc(capacity);
+    size_t length = 0;
+    // the first chunk takes whatever is left over, so the rest are all full
+    size_t chunk = count % CHUNK_DIGITS == 0 ? CHUNK_DIGITS : count % CHUNK_DIGITS;
+    for (size_t position = 0; position < count; position += chunk, chunk = CHUNK_DIGITS) {
+        uint32_t chunkValue = 0;
+        uint32_t scale = 1;
+        for (size_t i = 0; i < chunk; i++) {
+            chunkValue = chunkValue * 10 + (uint32_t)(text[position + i] - '0');
+            scale *= 10;
+        }
+        uint64_t carry = chunkValue;
+        for (size_t i = 0; i < length; i++) {
+            carry += (uint64_t)digits[i] * scale;
+            digits[i] = (uint32_t)carry;
+            carry >>= 32;
+        }
+        if (carry != 0) {
+            digits[length++] = (uint32_t)carry;
+        }
+    }
+    Value *result = makeInteger(negative, digits, length);
+    free(digits);
+    return result;
+}
+
+// integerToString
+// params: value - a pointer to an INT_TYPE or BIGNUM_TYPE Value
+// returns: a pointer to a new string holding the integer in decimal, to be given back with free
+char *integerToString(Value *value) {
+    if (typeOf(value) == INT_TYPE) {
+        char *text = textAlloc(24);
+        snprintf(text, 24, "%lld", (long long)intOf(value));
+        return text;
+    }
+    // divide a copy of the magnitude by 10^9 over and over, collecting the remainders least significant first
+    size_t length = value -> b -> length;
+    uint32_t *quotient = scratchAlloc(length + length * 32 / 29 + 1);
+    uint32_t *chunks = quotient + length;
+    memcpy(quotient, value -> b -> digits, length * sizeof(uint32_t));
+    size_t chunkCount = 0;
+    while (length > 0) {
+        uint64_t remainder = 0;
+        for (size_t i = length; i > 0; i--) {
+            remainder = (remainder << 32) | quotient[i - 1];
+            quotient[i - 1] = (uint32_t)(remainder / CHUNK_BASE);
+            remainder %= CHUNK_BASE;
+        }
+        chunks[chunkCount++] = (uint32_t)remainder;
+        length = trimmedLength(quotient, length);
+    }
+
+    char *text = textAlloc(chunkCount * CHUNK_DIGITS + 2);
+    char *end = text;
+    if (value -> b -> negative) {
+        *end++ = '-';
+    }
+    end += sprintf(end, "%u", chunks[chunkCount - 1]);
+    for (size_t i = chunkCount - 1; i > 0; i--) {
+        end += sprintf(end, "%09u", chunks[i - 1]);
+    }
+    free(quotient);
+    return text;
+}
+
+#endif
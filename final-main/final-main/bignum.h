@@ -0,0 +1,37 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include "value.h"
+
+#ifndef _BIGNUM
+#define _BIGNUM
+
+// Exact integer arithmetic. Each of these takes INT_TYPE or BIGNUM_TYPE
+// Values. Results that fit in 64 bits come back as INT_TYPE (usually a fixnum,
+// with nothing allocated); only bigger ones are BIGNUM_TYPE.
+
+// Return a + b, a - b and a * b.
+Value *integerAdd(Value *a, Value *b);
+Value *integerSubtract(Value *a, Value *b);
+Value *integerMultiply(Value *a, Value *b);
+
+// Return a negative number, zero or a positive number as a is less than,
+// equal to or greater than b.
+int integerCompare(Value *a, Value *b);
+
+// Return an unsigned 64-bit integer as a Value, and store an integer from 0 to
+// 2^64 - 1 in *number, returning false if it is out of that range.
+Value *integerFromUnsigned(uint64_t number);
+bool integerToUnsigned(Value *value, uint64_t *number);
+
+// Return the nearest double to the integer.
+double integerToDouble(Value *value);
+
+// Return the integer spelled by a string of decimal digits with an optional
+// sign, however many digits there are.
+Value *parseInteger(const char *text);
+
+// Return a new string holding the integer in decimal, which the caller has to
+// free.
+char *integerToString(Value *value);
+
+#endif
@@ -0,0 +1,107 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "value.h"
+#include "talloc.h"
+
+#ifndef _BYTEVECTOR
+#define _BYTEVECTOR
+
+// makeBytevector
+// params: length - the number of bytes
+// returns: a new Value with type BYTEVECTOR_TYPE whose bytes, in a payload of the value, are all 0
+Value *makeBytevector(uint64_t length) {
+    Value *value = talloc(sizeof(Value));
+    struct Bytevector *bytevector = tallocPayload(value, sizeof(struct Bytevector) + length);
+    bytevector -> length = length;
+    bytevector -> readOnly = false;
+    bytevector -> bytes = (uint8_t *)(bytevector + 1);
+    memset(bytevector -> bytes, 0, length);
+    value -> type = BYTEVECTOR_TYPE;
+    value -> bv = bytevector;
+    return value;
+}
+
+// unmapBytevector
+// params: memory - a pointer to the struct Bytevector of a bytevector made by fileToBytevector
+// returns: Nothing
+// unmaps the file, once the bytevector's payload is being freed
+void unmapBytevector(void *memory) {
+    struct Bytevector *bytevector = memory;
+    if (bytevector -> length > 0) {
+        munmap(bytevector -> bytes, bytevector -> length);
+    }
+}
+
+// fileToBytevector
+// params: path - the name of a file
+// returns: a new read-only Value with type BYTEVECTOR_TYPE holding the file's contents, or NULL if it can't be read
+// the file is mapped rather than read, so its pages are only loaded as they are used and are never copied; the
+// mapping outlives the file descriptor, which is closed straight away, and is unmapped when the bytevector is freed
+Value *fileToBytevector(const char *path) {
+    int file = open(path, O_RDONLY);
+    if (file < 0) {
+        return NULL;
+    }
+    struct stat status;
+    if (fstat(file, &status) != 0 || !S_ISREG(status.st_mode)) {
+        close(file);
+        return NULL;
+    }
+    uint64_t length = (uint64_t)status.st_size;
+    uint8_t *bytes = NULL;
+    if (length > 0) {
+        bytes = mmap(NULL, length, PROT_READ, MAP_PRIVATE, file, 0);
+        if (bytes == MAP_FAILED) {
+            close(file);
+            return NULL;
+        }
+    }
+    close(file);
+
+    Value *value = talloc(sizeof(Value));
+    struct Bytevector *bytevector = tallocPayload(value, sizeof(struct Bytevector));
+    bytevector -> length = length;
+    bytevector -> readOnly = true;
+    bytevector -> bytes = bytes;
+    tallocPayloadCleanup(bytevector, unmapBytevector);
+    value -> type = BYTEVECTOR_TYPE;
+    value -> bv = bytevector;
+    return value;
+}
+
+// bytevectorGet
+// params: bytevector - a pointer to a Value with type BYTEVECTOR_TYPE; index - where the number starts; width - its
+//         size in bytes: 1, 2, 4 or 8; bigEndian - true if its most significant byte comes first
+// returns: the number's bits, zero-extended
+// index + width must be within the bytevector
+uint64_t bytevectorGet(Value *bytevector, uint64_t index, int width, bool bigEndian) {
+    uint64_t bits = 0;
+    const uint8_t *bytes = bytevector -> bv -> bytes + index;
+    for (int i = 0; i < width; i++) {
+        int shift = bigEndian ? 8 * (width - 1 - i) : 8 * i;
+        bits |= (uint64_t)bytes[i] << shift;
+    }
+    return bits;
+}
+
+// bytevectorPut
+// params: bytevector - a pointer to a writable Value with type BYTEVECTOR_TYPE; index - where the number starts;
+//         width - its size in bytes: 1, 2, 4 or 8; bigEndian - true if its most significant byte comes first;
+//         bits - the number; only its low width bytes are stored
+// returns: Nothing
+void bytevectorPut(Value *bytevector, uint64_t index, int width, bool bigEndian, uint64_t bits) {
+    uint8_t *bytes = bytevector -> bv -> bytes + index;
+    for (int i = 0; i < width; i++) {
+        int shift = bigEndian ? 8 * (width - 1 - i) : 8 * i;
+        bytes[i] = (uint8_t)(bits >> shift);
+    }
+}
+
+#endif
@@ -0,0 +1,22 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include "value.h"
+
+#ifndef _BYTEVECTOR
+#define _BYTEVECTOR
+
+// Return a new, writable bytevector of length zero bytes.
+Value *makeBytevector(uint64_t length);
+
+// Return a read-only bytevector holding a file's contents, or NULL if the
+// file can't be read. The file is memory-mapped, not copied, so a file of any
+// size can be used without its bytes ever passing through Values.
+Value *fileToBytevector(const char *path);
+
+// Read or write the width-byte (1, 2, 4 or 8) unsigned number starting at
+// index, in big- or little-endian order. The caller checks that it is in
+// range, and that a bytevector written to isn't read-only.
+uint64_t bytevectorGet(Value *bytevector, uint64_t index, int width, bool bigEndian);
+void bytevectorPut(Value *bytevector, uint64_t index, int width, bool bigEndian, uint64_t bits);
+
+#endif
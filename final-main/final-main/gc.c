@@ -0,0 +1,660 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include "value.h"
+#include "talloc.h"
+
+#ifndef _GC
+#define _GC
+
+// Default number of pooled bytes before the first collection, and the default
+// factor the heap may grow by (relative to what survived) before the next one.
+#define DEFAULT_THRESHOLD (4 * 1024 * 1024)
+#define DEFAULT_GROWTH 2.0
+
+// Default number of bytes allocated in the nursery between minor collections.
+#define DEFAULT_NURSERY (1024 * 1024)
+
+// Default number of objects marked, and number of slabs swept, per safe point
+// while a collection is in progress.
+#define DEFAULT_MARK_STEP 4096
+#define SWEEP_STEP 4
+
+// Pause times are counted in power-of-two buckets of microseconds; the last
+// bucket holds everything from about a second up.
+#define PAUSE_BUCKETS 21
+
+// A root is the address of a C variable that holds a Value or Frame pointer.
+// The collector's own bookkeeping is malloc'd rather than talloc'd so it
+// never ends up in the heap it is collecting.
+typedef struct Root {
+    void **slot;
+    bool isFrame;
+} Root;
+
+// An entry on the mark stack: an object that has been marked (it is gray)
+// but whose children haven't been looked at yet. The copy queue of a minor
+// collection, holding objects that have been copied out of the nursery but
+// whose fields still point into it, and the remembered set, the objects
+// outside the nursery that have had a nursery pointer stored into them, are
+// kept in the same form.
+typedef struct Gray {
+    void *object;
+    bool isFrame;
+} Gray;
+
+// A full collection either runs all at once or, in incremental mode, is
+// spread over many safe points: marking a few thousand objects at a time, and
+// then sweeping a few slabs at a time (or leaving that to a sweeper thread).
+typedef enum {
+    IDLE, MARKING, SWEEPING
+} Phase;
+
+// define the root stack, the permanent roots, the mark stack, the copy queue and the collector's settings
+Root *roots = NULL;
+int rootCount = 0;
+int rootCapacity = 0;
+
+Root *permanentRoots = NULL;
+size_t permanentCount = 0;
+size_t permanentCapacity = 0;
+
+Gray *grays = NULL;
+size_t grayCount = 0;
+size_t grayCapacity = 0;
+
+Gray *copies = NULL;
+size_t copyCount = 0;
+size_t copyCapacity = 0;
+
+Gray *remembered = NULL;
+size_t rememberedCount = 0;
+size_t rememberedCapacity = 0;
+
+size_t initialThreshold = DEFAULT_THRESHOLD;
+double growthFactor = DEFAULT_GROWTH;
+size_t nextCollection = DEFAULT_THRESHOLD;
+bool collectorEnabled = true;
+bool releaseRegistered = false;
+
+Phase phase = IDLE;
+size_t markStep = DEFAULT_MARK_STEP;
+bool backgroundSweep = false;
+
+// define the pause-time histogram, kept only when SCHEME_GC_PAUSES is set
+bool recordPauses = false;
+size_t pauseCounts[PAUSE_BUCKETS];
+size_t pauseTotal = 0;
+double pauseSum = 0;
+double pauseMax = 0;
+
+// now
+// params: None
+// returns: the current time in seconds, from a clock that never jumps backwards
+double now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+// recordPause
+// params: seconds - how long the collector just held up the program
+// returns: Nothing
+void recordPause(double seconds) {
+    double micros = seconds * 1e6;
+    int bucket = 0;
+    while (bucket < PAUSE_BUCKETS - 1 && micros >= (double)((size_t)1 << bucket)) {
+        bucket++;
+    }
+    pauseCounts[bucket]++;
+    pauseTotal++;
+    pauseSum += seconds;
+    if (seconds > pauseMax) {
+        pauseMax = seconds;
+    }
+}
+
+// printPauses
+// params: None
+// returns: Nothing
+// prints the pause-time histogram to stderr, so it never mixes with the program's output
+void printPauses() {
+    fprintf(stderr, "GC pauses: %zu, total %.3f ms, max %.3f ms\n", pauseTotal, pauseSum * 1e3, pauseMax * 1e3);
+    for (int bucket = 0; bucket < PAUSE_BUCKETS; bucket++) {
+        if (pauseCounts[bucket] == 0) {
+            continue;
+        }
+        char label[32];
+        if (bucket == 0) {
+            snprintf(label, sizeof(label), "< 1");
+        } else if (bucket == PAUSE_BUCKETS - 1) {
+            snprintf(label, sizeof(label), ">= %zu", (size_t)1 << (bucket - 1));
+        } else {
+            snprintf(label, sizeof(label), "%zu-%zu", (size_t)1 << (bucket - 1), (size_t)1 << bucket);
+        }
+        fprintf(stderr, "  %16s us: %zu\n", label, pauseCounts[bucket]);
+    }
+}
+
+// gcRelease
+// params: None
+// returns: Nothing
+// prints the pause-time histogram if it was asked for and frees the collector's stacks; registered with atexit so
+// texit leaves nothing behind
+void gcRelease() {
+    if (recordPauses) {
+        printPauses();
+    }
+    free(roots);
+    free(permanentRoots);
+    free(grays);
+    free(copies);
+    free(remembered);
+    roots = NULL;
+    permanentRoots = NULL;
+    grays = NULL;
+    copies = NULL;
+    remembered = NULL;
+    rootCount = rootCapacity = 0;
+    permanentCount = permanentCapacity = 0;
+    grayCount = grayCapacity = 0;
+    copyCount = copyCapacity = 0;
+    rememberedCount = rememberedCapacity = 0;
+}
+
+// growOrDie
+// params: array - a pointer to a malloc'd array; capacity - a pointer to its capacity in elements; size - the size of one element
+// returns: the array, reallocated with double the capacity
+// exits the program if the system is out of memory
+void *growOrDie(void *array, size_t *capacity, size_t size) {
+    size_t newCapacity = *capacity == 0 ? 256 : *capacity * 2;
+    void *grown = realloc(array, newCapacity * size);
+    if (grown == NULL) {
+        printf("Error: out of memory\n");
+        texit(1);
+    }
+    *capacity = newCapacity;
+    return grown;
+}
+
+// gcInit
+// params: None
+// returns: Nothing
+// reads the collector's settings from the environment, sets up the nursery and schedules the first collection
+void gcInit() {
+    initialThreshold = DEFAULT_THRESHOLD;
+    growthFactor = DEFAULT_GROWTH;
+    collectorEnabled = true;
+    phase = IDLE;
+    markStep = DEFAULT_MARK_STEP;
+
+    char *threshold = getenv("SCHEME_GC_THRESHOLD");
+    if (threshold != NULL) {
+        initialThreshold = tallocParseSize(threshold);
+        collectorEnabled = initialThreshold > 0;
+    }
+    char *growth = getenv("SCHEME_GC_GROWTH");
+    if (growth != NULL && strtod(growth, NULL) >= 1.0) {
+        growthFactor = strtod(growth, NULL);
+    }
+    nextCollection = tallocPooledBytes() + initialThreshold;
+
+    size_t nurserySize = DEFAULT_NURSERY;
+    char *nursery = getenv("SCHEME_GC_NURSERY");
+    if (nursery != NULL) {
+        nurserySize = tallocParseSize(nursery);
+    }
+    tallocNurseryEnable(collectorEnabled ? nurserySize : 0);
+    rememberedCount = 0;
+
+    char *step = getenv("SCHEME_GC_INCREMENTAL");
+    if (step != NULL) {
+        markStep = tallocParseSize(step);
+    }
+    char *sweepThread = getenv("SCHEME_GC_SWEEP_THREAD");
+    backgroundSweep = sweepThread != NULL && strcmp(sweepThread, "0") != 0;
+    char *pauses = getenv("SCHEME_GC_PAUSES");
+    recordPauses = pauses != NULL && strcmp(pauses, "0") != 0;
+
+    if (!releaseRegistered) {
+        atexit(gcRelease);
+        releaseRegistered = true;
+    }
+}
+
+// pushRoot
+// params: slot - the address of a variable holding a Value or Frame pointer; isFrame - which of the two it holds
+// returns: Nothing
+void pushRoot(void **slot, bool isFrame) {
+    if (rootCount == rootCapacity) {
+        size_t capacity = rootCapacity;
+        roots = growOrDie(roots, &capacity, sizeof(Root));
+        rootCapacity = (int)capacity;
+    }
+    roots[rootCount].slot = slot;
+    roots[rootCount].isFrame = isFrame;
+    rootCount++;
+}
+
+// gcPushValue
+// params: slot - the address of a variable holding a Value pointer
+// returns: Nothing
+void gcPushValue(Value **slot) {
+    pushRoot((void **)slot, false);
+}
+
+// gcPushFrame
+// params: slot - the address of a variable holding a Frame pointer
+// returns: Nothing
+void gcPushFrame(Frame **slot) {
+    pushRoot((void **)slot, true);
+}
+
+// gcAddRoot
+// params: slot - the address of a Value pointer that lives until the program exits
+// returns: Nothing
+void gcAddRoot(Value **slot) {
+    if (permanentCount == permanentCapacity) {
+        permanentRoots = growOrDie(permanentRoots, &permanentCapacity, sizeof(Root));
+    }
+    permanentRoots[permanentCount].slot = (void **)slot;
+    permanentRoots[permanentCount].isFrame = false;
+    permanentCount++;
+}
+
+// gcPop
+// params: count - the number of roots to unregister
+// returns: Nothing
+void gcPop(int count) {
+    rootCount -= count;
+}
+
+// pushGray
+// params: stack - a pointer to a Gray array; count, capacity - pointers to its length and capacity;
+//         object - a pointer to a Value or Frame; isFrame - which of the two it is
+// returns: Nothing
+void pushGray(Gray **stack, size_t *count, size_t *capacity, void *object, bool isFrame) {
+    if (*count == *capacity) {
+        *stack = growOrDie(*stack, capacity, sizeof(Gray));
+    }
+    (*stack)[*count].object = object;
+    (*stack)[*count].isFrame = isFrame;
+    (*count)++;
+}
+
+// isHeapObject
+// params: object - a pointer to a Value or Frame, an immediate Value, or NULL
+// returns: true if there is an object on the heap for the collector to look at
+// static Values, such as the parse tree's, are left alone, since they never point at anything the collector manages
+bool isHeapObject(void *object) {
+    return object != NULL && !isImmediate(object) && !tallocIsStatic(object);
+}
+
+// shade
+// params: object - a pointer to a Value or Frame, an immediate Value, or NULL; isFrame - which of the two it is
+// returns: Nothing
+// marks the object and queues it so its children get marked too, unless it was already marked
+// nursery objects aren't marked; the minor collection that promotes them shades their copies instead
+void shade(void *object, bool isFrame) {
+    if (!isHeapObject(object) || tallocIsYoung(object) || !tallocMark(object)) {
+        return;
+    }
+    pushGray(&grays, &grayCount, &grayCapacity, object, isFrame);
+}
+
+// markEntries
+// params: entries - a hash table's array of slots, or NULL; capacity - how many slots it has
+// returns: Nothing
+// shades the key and value of every slot in use
+void markEntries(struct HashEntry *entries, uint32_t capacity) {
+    for (uint32_t slot = 0; entries != NULL && slot < capacity; slot++) {
+        if (entries[slot].hash > DELETED_SLOT) {
+            shade(VALUE_AT(entries[slot].key), false);
+            shade(VALUE_AT(entries[slot].value), false);
+        }
+    }
+}
+
+// markChildren
+// params: gray - a Gray entry taken off the mark stack
+// returns: Nothing
+// shades everything the object points to
+void markChildren(Gray gray) {
+    if (gray.isFrame) {
+        Frame *frame = gray.object;
+        shade(FRAME_AT(frame -> parent), true);
+        for (uint32_t slot = 0; slot < FRAME_SLOTS(frame); slot++) {
+            shade(VALUE_AT(frame -> slots[slot]), false);
+        }
+        return;
+    }
+
+    Value *value = gray.object;
+    switch (value -> type) {
+        case CONS_TYPE:
+            shade(VALUE_AT(value -> c.car), false);
+            shade(VALUE_AT(value -> c.cdr), false);
+            break;
+        case CLOSURE_TYPE:
+            shade(VALUE_AT(value -> cl.paramNames), false);
+            shade(VALUE_AT(value -> cl.functionCode), false);
+            shade(FRAME_AT(value -> cl.frame), true);
+            break;
+        case VECTOR_TYPE:
+            for (uint32_t i = 0; i < value -> vec -> length; i++) {
+                shade(VALUE_AT(value -> vec -> items[i]), false);
+            }
+            break;
+        case HASH_TYPE:
+            markEntries(value -> ht -> entries, value -> ht -> capacity);
+            markEntries(value -> ht -> oldEntries, value -> ht -> oldCapacity);
+            break;
+        case RECORD_TYPE:
+            for (uint32_t i = 0; i < value -> rec -> type -> fieldCount; i++) {
+                shade(VALUE_AT(value -> rec -> fields[i]), false);
+            }
+            break;
+        default:
+            // every other type is a leaf; whatever else it keeps, such as a string's characters, is never a Value
+            break;
+    }
+}
+
+// promote
+// params: object - a pointer to a Value or Frame in the nursery that hasn't been copied yet; isFrame - which of the two it is
+// returns: a pointer to the object's copy in the pools
+// copies the object, leaves a forwarding pointer behind and queues the copy so its fields get evacuated too
+// while a full collection is marking, the copy is shaded as well, since it may point at objects nothing has marked
+void *promote(void *object, bool isFrame) {
+    size_t size = isFrame ? FRAME_BYTES(FRAME_SLOTS((Frame *)object)) : sizeof(Value);
+    void *copy = tallocPromote(size, isFrame);
+    memcpy(copy, object, size);
+    tallocForward(object, copy);
+    pushGray(&copies, &copyCount, &copyCapacity, copy, isFrame);
+    if (phase == MARKING) {
+        shade(copy, isFrame);
+    }
+    return copy;
+}
+
+// evacuate
+// params: object - a pointer to a Value or Frame, an immediate Value, or NULL; isFrame - which of the two it is
+// returns: where the object lives now: its copy, if it's in the nursery, copying it first if nothing else has yet;
+// otherwise the object itself. When a cons cell is copied, the uncopied cells along its cdr chain are copied straight
+// after it, so the promoted list is laid out in cdr order rather than in whatever order its cells happen to be reached.
+void *evacuate(void *object, bool isFrame) {
+    if (!isHeapObject(object) || !tallocIsYoung(object)) {
+        return object;
+    }
+    void *copy = tallocForwarded(object);
+    if (copy != NULL) {
+        return copy;
+    }
+    copy = promote(object, isFrame);
+    if (isFrame) {
+        return copy;
+    }
+
+    Value *cell = copy;
+    while (cell -> type == CONS_TYPE) {
+        Value *next = VALUE_AT(cell -> c.cdr);
+        if (!isHeapObject(next) || !tallocIsYoung(next)) {
+            break;
+        }
+        Value *forwarded = tallocForwarded(next);
+        if (forwarded != NULL) {
+            cell -> c.cdr = REF(forwarded);
+            break;
+        }
+        next = promote(next, false);
+        cell -> c.cdr = REF(next);
+        cell = next;
+    }
+    return copy;
+}
+
+// evacuateEntries
+// params: entries - a hash table's array of slots, or NULL; capacity - how many slots it has
+// returns: Nothing
+// evacuates the key and value of every slot in use; empty and deleted slots' fields are never read again
+void evacuateEntries(struct HashEntry *entries, uint32_t capacity) {
+    for (uint32_t slot = 0; entries != NULL && slot < capacity; slot++) {
+        if (entries[slot].hash > DELETED_SLOT) {
+            entries[slot].key = REF(evacuate(VALUE_AT(entries[slot].key), false));
+            entries[slot].value = REF(evacuate(VALUE_AT(entries[slot].value), false));
+        }
+    }
+}
+
+// scanObject
+// params: gray - a Gray entry for an object outside the nursery
+// returns: Nothing
+// evacuates everything the object points to
+void scanObject(Gray gray) {
+    if (gray.isFrame) {
+        Frame *frame = gray.object;
+        frame -> parent = REF(evacuate(FRAME_AT(frame -> parent), true));
+        for (uint32_t slot = 0; slot < FRAME_SLOTS(frame); slot++) {
+            frame -> slots[slot] = REF(evacuate(VALUE_AT(frame -> slots[slot]), false));
+        }
+        return;
+    }
+
+    Value *value = gray.object;
+    switch (value -> type) {
+        case CONS_TYPE:
+            value -> c.car = REF(evacuate(VALUE_AT(value -> c.car), false));
+            value -> c.cdr = REF(evacuate(VALUE_AT(value -> c.cdr), false));
+            break;
+        case CLOSURE_TYPE:
+            value -> cl.paramNames = REF(evacuate(VALUE_AT(value -> cl.paramNames), false));
+            value -> cl.functionCode = REF(evacuate(VALUE_AT(value -> cl.functionCode), false));
+            value -> cl.frame = REF(evacuate(FRAME_AT(value -> cl.frame), true));
+            break;
+        case VECTOR_TYPE:
+            for (uint32_t i = 0; i < value -> vec -> length; i++) {
+                value -> vec -> items[i] = REF(evacuate(VALUE_AT(value -> vec -> items[i]), false));
+            }
+            break;
+        case HASH_TYPE:
+            evacuateEntries(value -> ht -> entries, value -> ht -> capacity);
+            evacuateEntries(value -> ht -> oldEntries, value -> ht -> oldCapacity);
+            break;
+        case RECORD_TYPE:
+            for (uint32_t i = 0; i < value -> rec -> type -> fieldCount; i++) {
+                value -> rec -> fields[i] = REF(evacuate(VALUE_AT(value -> rec -> fields[i]), false));
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// minorCollect
+// params: None
+// returns: Nothing
+// copies everything in the nursery that is reachable from the roots or the remembered set into the pools, in the
+// style of Cheney's algorithm with the copy queue standing in for the to-space scan pointer, then empties the nursery
+void minorCollect() {
+    copyCount = 0;
+    for (int i = 0; i < rootCount; i++) {
+        *roots[i].slot = evacuate(*roots[i].slot, roots[i].isFrame);
+    }
+    for (size_t i = 0; i < permanentCount; i++) {
+        *permanentRoots[i].slot = evacuate(*permanentRoots[i].slot, false);
+    }
+    for (size_t i = 0; i < rememberedCount; i++) {
+        tallocForget(remembered[i].object);
+        scanObject(remembered[i]);
+    }
+    rememberedCount = 0;
+    for (size_t scan = 0; scan < copyCount; scan++) {
+        scanObject(copies[scan]);
+    }
+    copyCount = 0;
+    tallocNurseryReset();
+}
+
+// gcRecordWrite
+// params: object - a pointer to the Value or Frame that was written to; isFrame - which of the two it is;
+//         stored - the Value pointer that was written into it
+// returns: Nothing
+// adds the object to the remembered set if it is outside the nursery and now points into it; while a full
+// collection is marking, also shades the stored Value, so an object that has already been scanned can't hide it
+void gcRecordWrite(void *object, bool isFrame, void *stored) {
+    if (!isHeapObject(stored)) {
+        return;
+    }
+    if (!tallocIsYoung(stored)) {
+        if (phase == MARKING) {
+            shade(stored, false);
+        }
+        return;
+    }
+    if (tallocIsYoung(object) || !tallocRemember(object)) {
+        return;
+    }
+    pushGray(&remembered, &rememberedCount, &rememberedCapacity, object, isFrame);
+}
+
+// shadeRoots
+// params: None
+// returns: Nothing
+void shadeRoots() {
+    for (int i = 0; i < rootCount; i++) {
+        shade(*roots[i].slot, roots[i].isFrame);
+    }
+    for (size_t i = 0; i < permanentCount; i++) {
+        shade(*permanentRoots[i].slot, false);
+    }
+}
+
+// markSome
+// params: budget - the most objects to scan
+// returns: true if the mark stack is empty afterwards
+// blackens objects from the mark stack by shading their children
+bool markSome(size_t budget) {
+    while (grayCount > 0 && budget > 0) {
+        grayCount--;
+        markChildren(grays[grayCount]);
+        budget--;
+    }
+    return grayCount == 0;
+}
+
+// scheduleNext
+// params: None
+// returns: Nothing
+// schedules the next full collection for growthFactor times the bytes that survived this one
+void scheduleNext() {
+    size_t live = tallocPooledBytes();
+    size_t next = (size_t)(live * growthFactor);
+    if (next < live + initialThreshold) {
+        next = live + initialThreshold;
+    }
+    nextCollection = next;
+}
+
+// finishMarking
+// params: None
+// returns: Nothing
+// ends the marking phase: the roots aren't covered by the write barrier, so they are scanned once more with the
+// program stopped, along with anything left in the nursery, and then sweeping starts
+void finishMarking() {
+    minorCollect();
+    shadeRoots();
+    markSome(SIZE_MAX);
+    tallocSweepBegin(backgroundSweep);
+    phase = SWEEPING;
+}
+
+// finishCycle
+// params: None
+// returns: Nothing
+// completes an incremental collection that is in progress, if there is one
+void finishCycle() {
+    if (phase == MARKING) {
+        finishMarking();
+    }
+    if (phase == SWEEPING) {
+        tallocSweepFinish();
+        phase = IDLE;
+        scheduleNext();
+    }
+}
+
+// gcCollect
+// params: None
+// returns: Nothing
+// finishes any collection in progress, then empties the nursery, marks everything reachable from the registered
+// roots, sweeps the rest back into the pools, and schedules the next collection for growthFactor times the surviving
+// bytes, all at once
+void gcCollect() {
+    finishCycle();
+    minorCollect();
+    shadeRoots();
+    markSome(SIZE_MAX);
+    tallocSweep();
+    scheduleNext();
+}
+
+// collectStep
+// params: None
+// returns: Nothing
+// does the work due at a safe point: a minor collection if the nursery is full, and then either a full collection,
+// or the next slice of an incremental one
+void collectStep() {
+    if (tallocNurseryFull()) {
+        minorCollect();
+    }
+    switch (phase) {
+        case IDLE:
+            if (tallocPooledBytes() < nextCollection && !tallocHeapPressure()) {
+                break;
+            }
+            if (markStep == 0) {
+                gcCollect();
+                break;
+            }
+            // everything in the nursery is promoted first, so only objects in the pools need marking
+            minorCollect();
+            phase = MARKING;
+            shadeRoots();
+            break;
+        case MARKING:
+            if (markSome(markStep)) {
+                finishMarking();
+            }
+            break;
+        case SWEEPING:
+            if (tallocSweepStep(backgroundSweep ? 0 : SWEEP_STEP)) {
+                phase = IDLE;
+                scheduleNext();
+            }
+            break;
+    }
+}
+
+// gcSafePoint
+// params: None
+// returns: Nothing
+// runs a minor collection if the nursery is full, and starts or continues a full one if the pools have grown past
+// the scheduled threshold
+void gcSafePoint() {
+    if (!collectorEnabled || (phase == IDLE && !tallocNurseryFull() && tallocPooledBytes() < nextCollection && !tallocHeapPressure())) {
+        return;
+    }
+    // checking on the sweeper thread isn't a pause worth recording
+    if (!recordPauses || (phase == SWEEPING && backgroundSweep && !tallocNurseryFull())) {
+        collectStep();
+        return;
+    }
+    double start = now();
+    collectStep();
+    recordPause(now() - start);
+}
+
+#endif
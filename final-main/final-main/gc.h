@@ -0,0 +1,67 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include "value.h"
+
+#ifndef _GC
+#define _GC
+
+// A precise, generational garbage collector for the Values and Frames that
+// talloc hands out. New objects are allocated in a nursery; a minor collection
+// copies the ones that are still reachable out into talloc's pools, copying a
+// list's cells one after another in cdr order so that surviving lists end up
+// contiguous, and then empties the nursery. The pools themselves are collected
+// by tri-color mark and sweep, which by default is incremental: marking and
+// sweeping are done a slice at a time, spread over many safe points, so pause
+// times don't grow with the size of the heap. Collections only run at safe points (see gcSafePoint), and
+// since a minor collection moves objects, any Value or Frame that C code still
+// needs after a safe point has to be reachable from a root: the global frame
+// and parse tree registered by interpret(), a global variable's binding (see
+// gcAddRoot), or a local variable registered with gcPushValue/gcPushFrame,
+// which the collector updates when it moves the object.
+// Code that stores a pointer into an existing Value or Frame must tell the
+// collector with gcRecordWrite; that is both the nursery's remembered set and
+// the incremental marker's write barrier.
+// Storage that a Value owns outside the pools, such as a bignum's digits (see
+// tallocPayload), is freed as soon as the collector finds the Value
+// unreachable, whether it dies in the nursery or in the pools.
+
+// Read the collector's settings from the environment and reset its state.
+// SCHEME_GC_THRESHOLD is the number of pooled bytes (a k, m or g suffix may be
+// used) that triggers the first collection. After each collection the next one
+// is scheduled for SCHEME_GC_GROWTH times the bytes that survived, or at least
+// SCHEME_GC_THRESHOLD bytes later. SCHEME_GC_THRESHOLD=0 turns the collector
+// off. SCHEME_GC_NURSERY is the size of the nursery, 1m by default; with
+// SCHEME_GC_NURSERY=0 everything is allocated straight from the pools.
+// SCHEME_GC_INCREMENTAL is the number of objects marked per safe point during
+// a full collection (4096 by default); 0 runs every full collection all at
+// once. SCHEME_GC_SWEEP_THREAD=1 sweeps on a background thread, and
+// SCHEME_GC_PAUSES=1 prints a histogram of pause times to stderr on exit.
+void gcInit();
+
+// Register the address of a local variable holding a Value or Frame pointer as
+// a root, until it is popped again with gcPop.
+void gcPushValue(Value **slot);
+void gcPushFrame(Frame **slot);
+
+// Register the address of a Value pointer that lives until the program exits,
+// such as a global variable's binding, as a root for good. Like the roots
+// pushed above, storing into it needs no gcRecordWrite.
+void gcAddRoot(Value **slot);
+
+// Unregister the count most recently pushed roots.
+void gcPop(int count);
+
+// Collect if enough has been allocated since the last collection, or do the
+// next slice of an incremental collection. eval() calls this on entry, which
+// makes every call to eval a safe point.
+void gcSafePoint();
+
+// Record that stored was just written into a field of object, a Value (or a
+// Frame, if isFrame is true), so that a minor collection doesn't miss a nursery
+// object that is only referenced from outside the nursery.
+void gcRecordWrite(void *object, bool isFrame, void *stored);
+
+// Collect the nursery and then the pools, now and all at once.
+void gcCollect();
+
+#endif
@@ -0,0 +1,146 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "value.h"
+#include "talloc.h"
+#include "gc.h"
+
+#ifndef _GLOBAL
+#define _GLOBAL
+
+// The table is an open-addressing hash table of cells, kept at most this full
+// (in percent) so probe sequences stay short. Cells are handed out from blocks
+// of CELL_BLOCK, which are never moved, so growing the table only moves
+// pointers to them.
+#define GLOBAL_LOAD 70
+#define CELL_BLOCK 256
+
+// A block of cells, and the block before it.
+typedef struct CellBlock {
+    struct CellBlock *next;
+    GlobalCell cells[CELL_BLOCK];
+} CellBlock;
+
+// define the table of cells (NULL for empty slots), its capacity (a power of two) and the number of cells in it, the
+// block cells are being handed out from and how many it has left, and whether freeGlobals has been registered to run
+// at exit
+GlobalCell **globals = NULL;
+size_t globalCapacity = 0;
+size_t globalCount = 0;
+CellBlock *cellBlocks = NULL;
+size_t cellsLeft = 0;
+bool globalsRegistered = false;
+
+// freeGlobals
+// params: None
+// returns: Nothing
+// frees the table and every block of cells; registered with atexit so texit leaves nothing behind
+void freeGlobals() {
+    while (cellBlocks != NULL) {
+        CellBlock *next = cellBlocks -> next;
+        free(cellBlocks);
+        cellBlocks = next;
+    }
+    free(globals);
+    globals = NULL;
+    globalCapacity = 0;
+    globalCount = 0;
+    cellsLeft = 0;
+}
+
+// callocOrDie
+// params: size - a number of bytes
+// returns: a pointer to size zeroed bytes from calloc
+// exits the program if the system is out of memory
+void *callocOrDie(size_t size) {
+    void *memory = calloc(1, size);
+    if (memory == NULL) {
+        printf("Error: out of memory\n");
+        texit(1);
+    }
+    return memory;
+}
+
+// globalSlot
+// params: name - an interned name; capacity - the capacity of the table, a power of two
+// returns: the slot to start probing for name at; names are interned, so it's the pointer that's hashed
+size_t globalSlot(char *name, size_t capacity) {
+    uint64_t hash = (uintptr_t)name * 11400714819323198485u;
+    return (hash ^ (hash >> 32)) & (capacity - 1);
+}
+
+// growGlobals
+// params: None
+// returns: Nothing
+// doubles the table's capacity, rehashing every cell into the new table
+void growGlobals() {
+    size_t newCapacity = globalCapacity == 0 ? 512 : globalCapacity * 2;
+    GlobalCell **grown = callocOrDie(newCapacity * sizeof(GlobalCell *));
+    for (size_t i = 0; i < globalCapacity; i++) {
+        if (globals[i] != NULL) {
+            size_t slot = globalSlot(globals[i] -> name, newCapacity);
+            while (grown[slot] != NULL) {
+                slot = (slot + 1) & (newCapacity - 1);
+            }
+            grown[slot] = globals[i];
+        }
+    }
+    free(globals);
+    globals = grown;
+    globalCapacity = newCapacity;
+    if (!globalsRegistered) {
+        atexit(freeGlobals);
+        globalsRegistered = true;
+    }
+}
+
+// globalLookup
+// params: name - an interned name
+// returns: the cell for name, or NULL if there is none
+GlobalCell *globalLookup(char *name) {
+    if (globalCapacity == 0) {
+        return NULL;
+    }
+    size_t slot = globalSlot(name, globalCapacity);
+    while (globals[slot] != NULL) {
+        if (globals[slot] -> name == name) {
+            return globals[slot];
+        }
+        slot = (slot + 1) & (globalCapacity - 1);
+    }
+    return NULL;
+}
+
+// globalCell
+// params: name - an interned name
+// returns: the cell for name, which is made unbound, and registered with the collector, if there wasn't one
+GlobalCell *globalCell(char *name) {
+    GlobalCell *cell = globalLookup(name);
+    if (cell != NULL) {
+        return cell;
+    }
+    if ((globalCount + 1) * 100 > globalCapacity * GLOBAL_LOAD) {
+        growGlobals();
+    }
+    if (cellsLeft == 0) {
+        CellBlock *block = callocOrDie(sizeof(CellBlock));
+        block -> next = cellBlocks;
+        cellBlocks = block;
+        cellsLeft = CELL_BLOCK;
+    }
+    cell = &cellBlocks -> cells[CELL_BLOCK - cellsLeft--];
+    cell -> name = name;
+    cell -> value = NULL;
+    gcAddRoot(&cell -> value);
+
+    size_t slot = globalSlot(name, globalCapacity);
+    while (globals[slot] != NULL) {
+        slot = (slot + 1) & (globalCapacity - 1);
+    }
+    globals[slot] = cell;
+    globalCount++;
+    return cell;
+}
+
+#endif
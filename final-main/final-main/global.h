@@ -0,0 +1,19 @@
+#include "value.h"
+
+#ifndef _GLOBAL
+#define _GLOBAL
+
+// The global environment: a hash table from interned symbol names to
+// GlobalCells. A name's cell is made the first time it's asked for and then
+// never moves or goes away, so whatever holds on to it sees every later define
+// and set! of the variable. Each cell's value is a root of the garbage
+// collector (see gcAddRoot), so storing into it is a plain assignment.
+
+// Return the cell for the given interned name, making an unbound one if there
+// isn't one yet.
+GlobalCell *globalCell(char *name);
+
+// Return the cell for the given interned name, or NULL if there isn't one.
+GlobalCell *globalLookup(char *name);
+
+#endif
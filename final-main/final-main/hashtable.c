@@ -0,0 +1,349 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include "value.h"
+#include "linkedlist.h"
+#include "talloc.h"
+#include "gc.h"
+#include "bignum.h"
+#include "symbol.h"
+
+#ifndef _HASHTABLE
+#define _HASHTABLE
+
+// Hash tables keep their entries in one array of HashEntry slots, each holding
+// a key's hash next to the key and value themselves, and find a key by probing
+// the slots after its home slot one at a time. A table grows before it is 70%
+// full. Growing doesn't rehash everything at once: the new array starts out
+// empty, and every operation on the table moves the next MIGRATE_STEP slots of
+// the old one across until none are left. Until then a key may be in either
+// array, so lookups try both.
+
+#define INITIAL_CAPACITY 8
+#define MIGRATE_STEP 8
+
+// how many items of a list or vector hashValue looks at, and how deep, before it stops; enough to tell keys apart
+// without taking longer than comparing them would, and without getting lost in a cycle
+#define HASH_ITEMS 16
+#define HASH_DEPTH 4
+
+// mixHash
+// params: hash - a hash so far; more - another hash to fold into it
+// returns: a hash of both
+uint64_t mixHash(uint64_t hash, uint64_t more) {
+    return (hash ^ more) * 1099511628211u;
+}
+
+// hashHelper
+// params: value - a pointer to a Value; depth - how many lists and vectors value is inside of
+// returns: a hash of the value such that values that are equal? have equal hashes
+// procedures and other values that are only equal? to themselves all hash alike, since the collector may move them
+uint64_t hashHelper(Value *value, int depth) {
+    valueType type = typeOf(value);
+    switch (type) {
+        case INT_TYPE: {
+            int64_t number = intOf(value);
+            return hashBytes((const char *)&number, sizeof(number));
+        }
+        case DOUBLE_TYPE:
+            return hashBytes((const char *)&value -> d, sizeof(double));
+        case BIGNUM_TYPE:
+            return hashBytes((const char *)value -> b -> digits, value -> b -> length * sizeof(uint32_t))
+                + (uint64_t)value -> b -> negative;
+        case STR_TYPE:
+            return stringHash(value);
+        case SYMBOL_TYPE:
+            return hashBytes(value -> s, strlen(value -> s));
+        case BOOL_TYPE:
+        case NULL_TYPE:
+        case VOID_TYPE:
+        case UNSPECIFIED_TYPE:
+            return (uintptr_t)value;
+        case CONS_TYPE: {
+            uint64_t hash = type;
+            if (depth >= HASH_DEPTH) {
+                return hash;
+            }
+            for (int i = 0; i < HASH_ITEMS && typeOf(value) == CONS_TYPE; i++) {
+                hash = mixHash(hash, hashHelper(car(value), depth + 1));
+                value = cdr(value);
+            }
+            if (typeOf(value) != CONS_TYPE) {
+                hash = mixHash(hash, hashHelper(value, depth + 1));
+            }
+            return hash;
+        }
+        case VECTOR_TYPE: {
+            uint64_t hash = mixHash(type, value -> vec -> length);
+            if (depth >= HASH_DEPTH) {
+                return hash;
+            }
+            for (uint32_t i = 0; i < HASH_ITEMS && i < value -> vec -> length; i++) {
+                hash = mixHash(hash, hashHelper(vectorRef(value, i), depth + 1));
+            }
+            return hash;
+        }
+        case RECORD_TYPE:
+            // a record is only equal? to itself, and its fields, unlike its Value, never move
+            return mixHash(type, (uintptr_t)value -> rec);
+        default:
+            return type;
+    }
+}
+
+// hashValue
+// params: value - a pointer to a Value
+// returns: the value's hash, folded to 32 bits and kept clear of the EMPTY_SLOT and DELETED_SLOT markers
+uint32_t hashValue(Value *value) {
+    uint64_t hash = hashHelper(value, 0);
+    uint32_t folded = (uint32_t)(hash ^ (hash >> 32));
+    return folded > DELETED_SLOT ? folded : folded + 2;
+}
+
+// valuesEqual
+// params: a, b - pointers to Values
+// returns: true if a and b are equal? : the same number, string or symbol, or lists or vectors of equal? items
+bool valuesEqual(Value *a, Value *b) {
+    while (a != b) {
+        if (typeOf(a) != typeOf(b)) {
+            return false;
+        }
+        switch (typeOf(a)) {
+            case INT_TYPE:
+                return intOf(a) == intOf(b);
+            case DOUBLE_TYPE:
+                return memcmp(&a -> d, &b -> d, sizeof(double)) == 0;
+            case BIGNUM_TYPE:
+                return integerCompare(a, b) == 0;
+            case STR_TYPE:
+                return a -> str.length == b -> str.length
+                    && memcmp(stringChars(a), stringChars(b), a -> str.length) == 0;
+            case SYMBOL_TYPE:
+                return a -> s == b -> s;
+            case VECTOR_TYPE:
+                if (a -> vec -> length != b -> vec -> length) {
+                    return false;
+                }
+                for (uint32_t i = 0; i < a -> vec -> length; i++) {
+                    if (!valuesEqual(vectorRef(a, i), vectorRef(b, i))) {
+                        return false;
+                    }
+                }
+                return true;
+            case CONS_TYPE:
+                if (!valuesEqual(car(a), car(b))) {
+                    return false;
+                }
+                a = cdr(a);
+                b = cdr(b);
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+// allocEntries
+// params: owner - the HASH_TYPE Value the slots belong to; capacity - a power of two
+// returns: a pointer to that many empty slots, freed along with owner
+struct HashEntry *allocEntries(Value *owner, uint32_t capacity) {
+    struct HashEntry *entries = tallocPayload(owner, capacity * sizeof(struct HashEntry));
+    memset(entries, 0, capacity * sizeof(struct HashEntry));
+    return entries;
+}
+
+// findSlot
+// params: entries, capacity - an array of slots and its length; hash - the key's hash; key - a pointer to the key
+// returns: the index of the slot holding the key, or -1 if it isn't there
+int64_t findSlot(struct HashEntry *entries, uint32_t capacity, uint32_t hash, Value *key) {
+    uint32_t mask = capacity - 1;
+    for (uint32_t slot = hash & mask; entries[slot].hash != EMPTY_SLOT; slot = (slot + 1) & mask) {
+        if (entries[slot].hash == hash && valuesEqual(VALUE_AT(entries[slot].key), key)) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+// placeEntry
+// params: table - a pointer to a HashTable; hash, key, value - a new entry, whose key isn't in either array yet
+// returns: Nothing
+// puts the entry in the first empty or deleted slot of the current array along its probe sequence
+void placeEntry(HashTable *table, uint32_t hash, ValueRef key, ValueRef value) {
+    uint32_t mask = table -> capacity - 1;
+    uint32_t slot = hash & mask;
+    while (table -> entries[slot].hash > DELETED_SLOT) {
+        slot = (slot + 1) & mask;
+    }
+    if (table -> entries[slot].hash == EMPTY_SLOT) {
+        table -> used++;
+    }
+    table -> entries[slot].hash = hash;
+    table -> entries[slot].key = key;
+    table -> entries[slot].value = value;
+}
+
+// migrate
+// params: table - a pointer to a HashTable; steps - how many old slots to move over at most
+// returns: Nothing
+// moves live entries from the old array to the current one, and lets go of the old array once they're all moved
+void migrate(HashTable *table, uint32_t steps) {
+    if (table -> oldEntries == NULL) {
+        return;
+    }
+    for (; steps > 0 && table -> migrated < table -> oldCapacity; steps--) {
+        struct HashEntry *old = &table -> oldEntries[table -> migrated];
+        if (old -> hash > DELETED_SLOT) {
+            placeEntry(table, old -> hash, old -> key, old -> value);
+            old -> hash = DELETED_SLOT;
+        }
+        table -> migrated++;
+    }
+    if (table -> migrated == table -> oldCapacity) {
+        tallocPayloadFree(table -> oldEntries);
+        table -> oldEntries = NULL;
+        table -> oldCapacity = 0;
+        table -> migrated = 0;
+    }
+}
+
+// startResize
+// params: table - a pointer to a HashTable whose current array is getting full; owner - the Value holding it
+// returns: Nothing
+// swaps in an empty array big enough that the table will be at most half full once everything has moved over, which
+// leaves the deleted slots behind as well; the entries themselves are moved by later calls to migrate
+void startResize(HashTable *table, Value *owner) {
+    migrate(table, UINT32_MAX);
+    uint32_t capacity = INITIAL_CAPACITY;
+    while (capacity < 2 * ((uint64_t)table -> count + 1)) {
+        if (capacity > UINT32_MAX / 2) {
+            printf("Evaluation error: out of memory\n");
+            texit(0);
+        }
+        capacity *= 2;
+    }
+    table -> oldEntries = table -> entries;
+    table -> oldCapacity = table -> capacity;
+    table -> migrated = 0;
+    table -> entries = allocEntries(owner, capacity);
+    table -> capacity = capacity;
+    table -> used = 0;
+}
+
+// makeHashTable
+// params: None
+// returns: a new, empty Value with type HASH_TYPE
+Value *makeHashTable() {
+    Value *value = talloc(sizeof(Value));
+    HashTable *table = tallocPayload(value, sizeof(HashTable));
+    table -> count = 0;
+    table -> capacity = INITIAL_CAPACITY;
+    table -> used = 0;
+    table -> entries = allocEntries(value, INITIAL_CAPACITY);
+    table -> oldCapacity = 0;
+    table -> migrated = 0;
+    table -> oldEntries = NULL;
+    value -> type = HASH_TYPE;
+    value -> ht = table;
+    return value;
+}
+
+// hashTableRef
+// params: table - a pointer to a Value with type HASH_TYPE; key - a pointer to a Value
+// returns: a pointer to the Value stored under a key equal? to the given one, or NULL if there isn't one
+Value *hashTableRef(Value *table, Value *key) {
+    assert(typeOf(table) == HASH_TYPE);
+    HashTable *ht = table -> ht;
+    uint32_t hash = hashValue(key);
+    int64_t slot = findSlot(ht -> entries, ht -> capacity, hash, key);
+    if (slot >= 0) {
+        return VALUE_AT(ht -> entries[slot].value);
+    }
+    if (ht -> oldEntries != NULL) {
+        slot = findSlot(ht -> oldEntries, ht -> oldCapacity, hash, key);
+        if (slot >= 0) {
+            return VALUE_AT(ht -> oldEntries[slot].value);
+        }
+    }
+    return NULL;
+}
+
+// hashTableSet
+// params: table - a pointer to a Value with type HASH_TYPE; key, value - pointers to Values
+// returns: Nothing
+// stores value under key, replacing whatever was stored under a key equal? to it. Tells the garbage collector.
+void hashTableSet(Value *table, Value *key, Value *value) {
+    assert(typeOf(table) == HASH_TYPE);
+    HashTable *ht = table -> ht;
+    migrate(ht, MIGRATE_STEP);
+    gcRecordWrite(table, false, key);
+    gcRecordWrite(table, false, value);
+
+    uint32_t hash = hashValue(key);
+    int64_t slot = findSlot(ht -> entries, ht -> capacity, hash, key);
+    if (slot >= 0) {
+        ht -> entries[slot].value = REF(value);
+        return;
+    }
+    if (ht -> oldEntries != NULL) {
+        slot = findSlot(ht -> oldEntries, ht -> oldCapacity, hash, key);
+        if (slot >= 0) {
+            ht -> oldEntries[slot].value = REF(value);
+            return;
+        }
+    }
+
+    if ((uint64_t)(ht -> used + 1) * 10 > (uint64_t)ht -> capacity * 7) {
+        startResize(ht, table);
+    }
+    placeEntry(ht, hash, REF(key), REF(value));
+    ht -> count++;
+}
+
+// hashTableDelete
+// params: table - a pointer to a Value with type HASH_TYPE; key - a pointer to a Value
+// returns: true if there was an entry under a key equal? to key, which is now removed, and false otherwise
+bool hashTableDelete(Value *table, Value *key) {
+    assert(typeOf(table) == HASH_TYPE);
+    HashTable *ht = table -> ht;
+    migrate(ht, MIGRATE_STEP);
+    uint32_t hash = hashValue(key);
+    struct HashEntry *entries = ht -> entries;
+    int64_t slot = findSlot(entries, ht -> capacity, hash, key);
+    if (slot < 0 && ht -> oldEntries != NULL) {
+        entries = ht -> oldEntries;
+        slot = findSlot(entries, ht -> oldCapacity, hash, key);
+    }
+    if (slot < 0) {
+        return false;
+    }
+    entries[slot].hash = DELETED_SLOT;
+    ht -> count--;
+    return true;
+}
+
+// hashTableEntries
+// params: table - a pointer to a Value with type HASH_TYPE
+// returns: a new list of (key . value) pairs, one for each entry in the table, in no particular order
+Value *hashTableEntries(Value *table) {
+    assert(typeOf(table) == HASH_TYPE);
+    HashTable *ht = table -> ht;
+    Value *entries = makeNull();
+    struct HashEntry *arrays[] = {ht -> entries, ht -> oldEntries};
+    uint32_t capacities[] = {ht -> capacity, ht -> oldCapacity};
+    for (int i = 0; i < 2; i++) {
+        for (uint32_t slot = 0; arrays[i] != NULL && slot < capacities[i]; slot++) {
+            if (arrays[i][slot].hash > DELETED_SLOT) {
+                Value *pair = cons(VALUE_AT(arrays[i][slot].key), VALUE_AT(arrays[i][slot].value));
+                entries = cons(pair, entries);
+            }
+        }
+    }
+    return entries;
+}
+
+#endif
@@ -0,0 +1,33 @@
+#include <stdbool.h>
+#include "value.h"
+
+#ifndef _HASHTABLE
+#define _HASHTABLE
+
+// Mutable hash tables keyed by equal? : two keys are the same key if they are
+// the same number, string or symbol, or lists or vectors whose items are equal?
+// one by one. Any other Value, a procedure say, is only equal? to itself.
+
+// Return true if a and b are equal?, and a hash of value that is the same for
+// all Values that are equal? to each other.
+bool valuesEqual(Value *a, Value *b);
+uint32_t hashValue(Value *value);
+
+// Return a new, empty HASH_TYPE value.
+Value *makeHashTable();
+
+// Return the value stored under key in table, or NULL if there is none.
+Value *hashTableRef(Value *table, Value *key);
+
+// Store value under key in table, replacing any value already stored there.
+// Like setCdr, this tells the garbage collector about the write.
+void hashTableSet(Value *table, Value *key, Value *value);
+
+// Remove key and its value from table. Return false if it wasn't there.
+bool hashTableDelete(Value *table, Value *key);
+
+// Return a new list of (key . value) pairs, one per entry, in no particular
+// order.
+Value *hashTableEntries(Value *table);
+
+#endif
@@ -3,6 +3,16 @@
 #include "linkedlist.h"
 #include "talloc.h"
 #include "parser.h"
+#include "gc.h"
+#include "bignum.h"
+#include "symbol.h"
+#include "hashtable.h"
+#include "numvector.h"
+#include "bytevector.h"
+#include "record.h"
+#include "resolver.h"
+#include "global.h"
+#include "special.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -12,8 +22,50 @@
 #ifndef _INTERPRETER
 #define _INTERPRETER
 
-// define eval
+// define eval, and apply for the primitives that call procedures
 Value *eval(Value *, Frame *);
+Value *apply(Value *, Value *);
+
+// define the global frame, which the collector treats as a root; it has no slots, since its variables are in the global
+// environment's table (see global.h)
+Frame *globalFrame = NULL;
+
+/*
+isNumber
+params: value - a pointer to a Value
+returns: true if value is an integer (of any size) or a double, false otherwise
+*/
+bool isNumber(Value *value) {
+    valueType type = typeOf(value);
+    return type == INT_TYPE || type == BIGNUM_TYPE || type == DOUBLE_TYPE;
+}
+
+/*
+numberToDouble
+params: value - a pointer to a Value holding a number
+returns: the number as a double
+*/
+double numberToDouble(Value *value) {
+    if (typeOf(value) == DOUBLE_TYPE) {
+        return value -> d;
+    }
+    return integerToDouble(value);
+}
+
+/*
+compareNumbers
+params: a, b - pointers to Values holding numbers
+returns: a negative number, zero or a positive number as a is less than, equal to or greater than b
+Integers are compared exactly, however big; if either number is a double, both are compared as doubles.
+*/
+int compareNumbers(Value *a, Value *b) {
+    if (typeOf(a) == DOUBLE_TYPE || typeOf(b) == DOUBLE_TYPE) {
+        double x = numberToDouble(a);
+        double y = numberToDouble(b);
+        return x < y ? -1 : x > y ? 1 : 0;
+    }
+    return integerCompare(a, b);
+}
 
 /*
 primtiveMinus
@@ -24,62 +76,55 @@ If no arguments are provided, primitiveMinus throws an error
 */
 Value *primitiveMinus(Value *args) {
     // Checks if no arguments were provided, and if so throw an error
-    if (args -> type == NULL_TYPE) {
+    if (typeOf(args) == NULL_TYPE) {
         printf("Evaluation error: no argument provided for '-'\n");
         texit(0);
     }
 
-    int differenceAsInt = 0;
+    Value *differenceAsInteger = makeInt(0);
     double differenceAsDouble = 0;
     bool allInts = true;
 
     Value *current = args;
 
     // case where there is one argument
-    if (cdr(args) -> type != NULL_TYPE) {
-        if (car(args) -> type == DOUBLE_TYPE) {
+    if (typeOf(cdr(args)) != NULL_TYPE) {
+        if (typeOf(car(args)) == DOUBLE_TYPE) {
             allInts = false;
             differenceAsDouble = car(args) -> d;
             current = cdr(current);
-        } else if (car(args) -> type == INT_TYPE) {
-            differenceAsInt = car(args) -> i;
+        } else if (isNumber(car(args))) {
+            differenceAsInteger = car(args);
             current = cdr(current);
         }
     }
 
     // case where there are more than one argument
     Value *currentValue;
-    while (current -> type != NULL_TYPE) {
+    while (typeOf(current) != NULL_TYPE) {
         currentValue = car(current);
-        if (currentValue -> type != INT_TYPE && currentValue -> type != DOUBLE_TYPE) {
+        if (!isNumber(currentValue)) {
             printf("Evaluation error: non real-number arguments for '-'\n");
             texit(0);
         // If a double type seen in the arguments, switches sum to be stored as a double
-        } else if (currentValue -> type == DOUBLE_TYPE && allInts) {
-            differenceAsDouble = differenceAsInt - currentValue -> d;
+        } else if (typeOf(currentValue) == DOUBLE_TYPE && allInts) {
+            differenceAsDouble = integerToDouble(differenceAsInteger) - currentValue -> d;
             allInts = false;      
         } else if (allInts) {
-            differenceAsInt = differenceAsInt - currentValue -> i;
+            differenceAsInteger = integerSubtract(differenceAsInteger, currentValue);
         } else {
-            if (currentValue -> type == INT_TYPE) {
-                differenceAsDouble = differenceAsDouble - currentValue -> i;
-            } else {
-                differenceAsDouble = differenceAsDouble - currentValue -> d;
-            }
+            differenceAsDouble = differenceAsDouble - numberToDouble(currentValue);
         }
         current = cdr(current);
     }
 
     // make sure result is of the proper type
-    Value *result = talloc(sizeof(Value));
     if (allInts) {
-        result -> type = INT_TYPE;
-        result -> i = differenceAsInt;
-    } else {
-        result -> type = DOUBLE_TYPE;
-        result -> d = differenceAsDouble;
+        return differenceAsInteger;
     }
-
+    Value *result = talloc(sizeof(Value));
+    result -> type = DOUBLE_TYPE;
+    result -> d = differenceAsDouble;
     return result;
 }
 
@@ -91,65 +136,31 @@ primitiveLessThan() returns the result of whether all its argument's adjacent pa
 Throws an error if a non-numerical argument is given
 */
 Value *primitiveLessThan(Value *args) {
-    // result is initially set to true
-    Value *result = talloc(sizeof(Value));
-    result -> type = BOOL_TYPE;
-    result -> i = 1;
-
     // Check if there are no arguments
-    if (args -> type == NULL_TYPE) {
-        return result;
+    if (typeOf(args) == NULL_TYPE) {
+        return TRUE_VALUE;
     }
 
     Value *current = args;
     // Check if the first argument is a numerial type
-    if (car(current) -> type != INT_TYPE && car(current) -> type != DOUBLE_TYPE) {
+    if (!isNumber(car(current))) {
         printf("Evaluation error: non numerical argument for '<'\n");
         texit(0); 
     }
 
-    while (cdr(current) -> type != NULL_TYPE) {
+    while (typeOf(cdr(current)) != NULL_TYPE) {
         // Check if the next argument is a numerical type
-        if (car(cdr(current)) -> type != INT_TYPE && car(cdr(current)) -> type != DOUBLE_TYPE) {
+        if (!isNumber(car(cdr(current)))) {
             printf("Evaluation error: non numerical argument for '<'\n");
             texit(0); 
         }
-        // Is the current argument of double type?
-        if (car(current) -> type == DOUBLE_TYPE) {
-            // Is the next argument of double type?
-            if (car(cdr(current)) -> type == DOUBLE_TYPE) {
-                if (car(current) -> d >= car(cdr(current)) -> d) {
-                    result -> i = 0;
-                    return result;
-                }
-            // The next argument must be of int type
-            } else {
-                if (car(current) -> d >= car(cdr(current)) -> i) {
-                    result -> i = 0;
-                    return result;
-                }
-            }
-
-        // The current argument must be of int type
-        } else {
-            // Is the next argument of double type?
-            if (car(cdr(current)) -> type == DOUBLE_TYPE) {
-                if (car(current) -> i >= car(cdr(current)) -> d) {
-                    result -> i = 0;
-                    return result;
-                }
-            // The next argument must be of int type
-            } else {
-                if (car(current) -> i >= car(cdr(current)) -> i) {
-                    result -> i = 0;
-                    return result;
-                }
-            }
+        if (compareNumbers(car(current), car(cdr(current))) >= 0) {
+            return FALSE_VALUE;
         }
         current = cdr(current);
     }
 
-    return result;
+    return TRUE_VALUE;
 }
 
 /*
@@ -160,65 +171,31 @@ primitiveGreatorThan() returns the result of whether all its argument's adjacent
 Throws an error if a non-numerical argument is given
 */
 Value *primitiveGreatorThan(Value *args) {
-    // result is initially set to true
-    Value *result = talloc(sizeof(Value));
-    result -> type = BOOL_TYPE;
-    result -> i = 1;
-
     // Check if there are no arguments
-    if (args -> type == NULL_TYPE) {
-        return result;
+    if (typeOf(args) == NULL_TYPE) {
+        return TRUE_VALUE;
     }
 
     Value *current = args;
     // Check if the first argument is a numerial type
-    if (car(current) -> type != INT_TYPE && car(current) -> type != DOUBLE_TYPE) {
+    if (!isNumber(car(current))) {
         printf("Evaluation error: non numerical argument for '>'\n");
         texit(0); 
     }
 
-    while (cdr(current) -> type != NULL_TYPE) {
+    while (typeOf(cdr(current)) != NULL_TYPE) {
         // Check if the next argument is a numerical type
-        if (car(cdr(current)) -> type != INT_TYPE && car(cdr(current)) -> type != DOUBLE_TYPE) {
+        if (!isNumber(car(cdr(current)))) {
             printf("Evaluation error: non numerical argument for '>'\n");
             texit(0); 
         }
-        // Is the current argument of double type?
-        if (car(current) -> type == DOUBLE_TYPE) {
-            // Is the next argument of double type?
-            if (car(cdr(current)) -> type == DOUBLE_TYPE) {
-                if (car(current) -> d <= car(cdr(current)) -> d) {
-                    result -> i = 0;
-                    return result;
-                }
-            // The next argument must be of int type
-            } else {
-                if (car(current) -> d <= car(cdr(current)) -> i) {
-                    result -> i = 0;
-                    return result;
-                }
-            }
-
-        // The current argument must be of int type
-        } else {
-            // Is the next argument of double type?
-            if (car(cdr(current)) -> type == DOUBLE_TYPE) {
-                if (car(current) -> i <= car(cdr(current)) -> d) {
-                    result -> i = 0;
-                    return result;
-                }
-            // The next argument must be of int type
-            } else {
-                if (car(current) -> i <= car(cdr(current)) -> i) {
-                    result -> i = 0;
-                    return result;
-                }
-            }
+        if (compareNumbers(car(current), car(cdr(current))) <= 0) {
+            return FALSE_VALUE;
         }
         current = cdr(current);
     }
 
-    return result;
+    return TRUE_VALUE;
 }
 
 /*
@@ -229,53 +206,21 @@ primitiveEqual() returns the result of whether all its arguments are equal
 Throws an error if a non-numerical argument is given
 */
 Value *primitiveEqual(Value *args) {
-    // result is initially set to true
-    Value *result = talloc(sizeof(Value));
-    result -> type = BOOL_TYPE;
-    result -> i = 1;
-
     Value *current = args;
-    while (current -> type != NULL_TYPE) {
+    while (typeOf(current) != NULL_TYPE) {
         // Checks if argument is neither a float nor an int
-        if (car(current) -> type != INT_TYPE && car(current) -> type != DOUBLE_TYPE) {
+        if (!isNumber(car(current))) {
             printf("Evaluation error: non numerical argument for '='\n");
             texit(0);
         }
 
-        // is the current arg of type double?
-        if (car(current) -> type == DOUBLE_TYPE) {
-            // is the first arg of type double?
-            if (car(args) -> type == DOUBLE_TYPE) {
-                if (car(current) -> d != car(args) -> d) {
-                    result -> i = 0;
-                    return result;
-                }
-            } else {
-                if (car(current) -> d != car(args) -> i) {
-                    result -> i = 0;
-                    return result;
-                }
-            }
-        
-        // current arg is an int type
-        } else {
-            // is the first arg of type double?
-            if (car(args) -> type == DOUBLE_TYPE) {
-                if (car(current) -> i != car(args) -> d) {
-                    result -> i = 0;
-                    return result;
-                }
-            } else {
-                if (car(current) -> i != car(args) -> i) {
-                    result -> i = 0;
-                    return result;
-                }
-            }
+        if (compareNumbers(car(current), car(args)) != 0) {
+            return FALSE_VALUE;
         }
 
         current = cdr(current);
     }
-    return result;
+    return TRUE_VALUE;
 }
 
 /*
@@ -287,48 +232,78 @@ If no arguments are provided, primitivePlus returns a pointer to a Value contain
 */
 Value *primitivePlus(Value *args) {
     // Checks if no arguments were provided, and if so returns a pointer to an integer-type Value containing 0
-    if (args -> type == NULL_TYPE) {
-        Value *result = talloc(sizeof(Value));
-        result -> type = INT_TYPE;
-        result -> i = 0;
+    if (typeOf(args) == NULL_TYPE) {
+        return makeInt(0);
     }
    
    Value *current = args;
    Value *currentValue;
-   int sumAsInt = 0;
+   Value *sumAsInteger = makeInt(0);
    double sumAsDouble = 0;
    bool allInts = true;
-   while (current -> type != NULL_TYPE) {
+   while (typeOf(current) != NULL_TYPE) {
         currentValue = car(current);
-        if (currentValue -> type != INT_TYPE && currentValue -> type != DOUBLE_TYPE) {
+        if (!isNumber(currentValue)) {
             printf("Evaluation error: attempting to sum non real-number arguments\n");
             texit(0);
         // If a double type seen in the arguments, switches sum to be stored as a double
-        } else if (currentValue -> type == DOUBLE_TYPE && allInts) {
-            sumAsDouble = sumAsInt + currentValue -> d;
+        } else if (typeOf(currentValue) == DOUBLE_TYPE && allInts) {
+            sumAsDouble = integerToDouble(sumAsInteger) + currentValue -> d;
             allInts = false;      
         } else if (allInts) {
-            sumAsInt = sumAsInt + currentValue -> i;
+            sumAsInteger = integerAdd(sumAsInteger, currentValue);
         } else {
-            if (currentValue -> type == INT_TYPE) {
-                sumAsDouble = sumAsDouble + currentValue -> i;
-            } else {
-                sumAsDouble = sumAsDouble + currentValue -> d;
-            }
+            sumAsDouble = sumAsDouble + numberToDouble(currentValue);
         }
         current = cdr(current);
     }
 
     // make sure result is of the proper type and has its data stored in the proper locations
-    Value *result = talloc(sizeof(Value));
     if (allInts) {
-        result -> type = INT_TYPE;
-        result -> i = sumAsInt;
-    } else {
-        result -> type = DOUBLE_TYPE;
-        result -> d = sumAsDouble;
+        return sumAsInteger;
+    }
+    Value *result = talloc(sizeof(Value));
+    result -> type = DOUBLE_TYPE;
+    result -> d = sumAsDouble;
+    return result;
+}
+
+/*
+primitiveMultiply
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a Value containing an integer or double that equals the product of the arguments
+primitiveMultiply() throws an error if it encounters a non real-number argument
+If no arguments are provided, primitiveMultiply returns a pointer to a Value containing 1
+*/
+Value *primitiveMultiply(Value *args) {
+    Value *current = args;
+    Value *currentValue;
+    Value *productAsInteger = makeInt(1);
+    double productAsDouble = 1;
+    bool allInts = true;
+    while (typeOf(current) != NULL_TYPE) {
+        currentValue = car(current);
+        if (!isNumber(currentValue)) {
+            printf("Evaluation error: attempting to multiply non real-number arguments\n");
+            texit(0);
+        // If a double type seen in the arguments, switches product to be stored as a double
+        } else if (typeOf(currentValue) == DOUBLE_TYPE && allInts) {
+            productAsDouble = integerToDouble(productAsInteger) * currentValue -> d;
+            allInts = false;
+        } else if (allInts) {
+            productAsInteger = integerMultiply(productAsInteger, currentValue);
+        } else {
+            productAsDouble = productAsDouble * numberToDouble(currentValue);
+        }
+        current = cdr(current);
     }
 
+    if (allInts) {
+        return productAsInteger;
+    }
+    Value *result = talloc(sizeof(Value));
+    result -> type = DOUBLE_TYPE;
+    result -> d = productAsDouble;
     return result;
 }
 
@@ -340,107 +315,1326 @@ primitiveNull() throws an error if greater or fewer than one argument is provide
 The boolean-type Value returned by primitiveNull() will contain true if the argument was an empty list, and false in any other case. 
 */
 Value *primitiveNull(Value *args) {
-    if (args -> type == NULL_TYPE || cdr(args) -> type != NULL_TYPE) {
+    if (typeOf(args) == NULL_TYPE || typeOf(cdr(args)) != NULL_TYPE) {
         printf("Evaluation error: incorrect number of args for 'null?'\n");
         texit(0);
     } else {
         Value *arg = car(args);
-        Value *result = talloc(sizeof(Value));
-        result -> type = BOOL_TYPE;
-        if (args -> type == CONS_TYPE) {
-            if (isNull(arg)) {
-                result -> i = 1;
-            } else {
-                result -> i = 0;
-            }
+        if (typeOf(args) == CONS_TYPE && isNull(arg)) {
+            return TRUE_VALUE;
+        }
+        return FALSE_VALUE;
+    }
+    return makeNull();
+}
+
+/*
+primitiveCar
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a Value representing the first item in a given list
+primitiveCar() will throw an error if it is given greater or fewer than one argument.
+*/
+Value *primitiveCar(Value *args) {
+    if (typeOf(args) == NULL_TYPE || typeOf(cdr(args)) != NULL_TYPE) {
+        printf("Evaluation error: incorrect number of args for 'car'\n");
+        texit(0);
+    } else {
+        Value *arg = car(args);
+        if (typeOf(arg) != CONS_TYPE) {
+            printf("Evaluation error: argument to car is not a cons cell\n");
+            texit(0);
         } else {
-            result -> i = 0;
+            return car(arg);
         }
-        return result;
     }
     return makeNull();
 }
 
 /*
-primitiveCar
+primitiveCdr
+params: a pointer to a Value representing a linked list of arguments
+returns: a pointer to a Value representing everything but the first item in a given list
+primitiveCdr() will throw an error if it is given greater or fewer than one argument.
+*/
+Value *primitiveCdr(Value *args) {
+    if (typeOf(args) == NULL_TYPE || typeOf(cdr(args)) != NULL_TYPE) {
+        printf("Evaluation error: incorrect number of args for 'cdr'\n");
+        texit(0);
+    } else {
+        Value *arg = car(args);
+        if (typeOf(arg) != CONS_TYPE) {
+            printf("Evaluation error: argument to cdr is not a cons cell\n");
+            texit(0);
+        } else {
+            return cdr(arg);
+        }
+    }
+    return makeNull();
+}
+
+/*
+primitiveCons
+params: args - a pointer to a Value struct
+returns: a pointer to a Value struct
+Returns a Cons cell of the two values contained within args. If args does not contain exactly two args, throw an error.
+*/
+Value *primitiveCons(Value *args) {
+    // If args does not contain exactly two args, throw an error.
+    if (typeOf(args) == NULL_TYPE || typeOf(cdr(args)) == NULL_TYPE || typeOf(cdr(cdr(args))) != NULL_TYPE) {
+        printf("Evaluation error: incorrect number of args for 'cons'\n");
+        texit(0);
+
+    } else {
+        return cons(car(args), car(cdr(args)));
+    }
+    return makeNull();
+}
+
+/*
+vectorArg
+params: arg - a pointer to a Value, name - the name of the primitive it was passed to
+returns: arg, once it is known to be a vector
+vectorArg() throws an error if arg is not a vector.
+*/
+Value *vectorArg(Value *arg, char *name) {
+    if (typeOf(arg) != VECTOR_TYPE) {
+        printf("Evaluation error: argument to %s is not a vector\n", name);
+        texit(0);
+    }
+    return arg;
+}
+
+/*
+indexArg
+params: arg - a pointer to a Value, limit - one more than the largest index allowed, name - the name of the primitive
+returns: arg as an index
+indexArg() throws an error if arg is not an integer from 0 up to (but not including) limit.
+*/
+uint32_t indexArg(Value *arg, uint32_t limit, char *name) {
+    if (typeOf(arg) != INT_TYPE || intOf(arg) < 0 || intOf(arg) >= limit) {
+        printf("Evaluation error: index out of range for '%s'\n", name);
+        texit(0);
+    }
+    return (uint32_t)intOf(arg);
+}
+
+/*
+primitiveMakeVector
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a new vector-type Value
+primitiveMakeVector() throws an error if it is not given a length, and optionally a fill value, which defaults to 0.
+*/
+Value *primitiveMakeVector(Value *args) {
+    if (length(args) != 1 && length(args) != 2) {
+        printf("Evaluation error: incorrect number of args for 'make-vector'\n");
+        texit(0);
+    }
+    Value *fill = length(args) == 2 ? car(cdr(args)) : makeInt(0);
+    return makeVector(indexArg(car(args), UINT32_MAX, "make-vector"), fill);
+}
+
+/*
+primitiveVector
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a new vector-type Value holding the arguments, in order
+*/
+Value *primitiveVector(Value *args) {
+    Value *vector = makeVector(length(args), UNSPECIFIED_VALUE);
+    for (uint32_t i = 0; typeOf(args) == CONS_TYPE; i++) {
+        vectorSet(vector, i, car(args));
+        args = cdr(args);
+    }
+    return vector;
+}
+
+/*
+primitiveVectorRef
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to the Value at the given index of the given vector
+primitiveVectorRef() throws an error if it is not given exactly a vector and an index that is in range.
+*/
+Value *primitiveVectorRef(Value *args) {
+    if (length(args) != 2) {
+        printf("Evaluation error: incorrect number of args for 'vector-ref'\n");
+        texit(0);
+    }
+    Value *vector = vectorArg(car(args), "vector-ref");
+    return vectorRef(vector, indexArg(car(cdr(args)), vector -> vec -> length, "vector-ref"));
+}
+
+/*
+primitiveVectorSet
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a void-type Value
+primitiveVectorSet() replaces the item at the given index of the given vector. It throws an error if it is not given
+exactly a vector, an index that is in range and a new item.
+*/
+Value *primitiveVectorSet(Value *args) {
+    if (length(args) != 3) {
+        printf("Evaluation error: incorrect number of args for 'vector-set!'\n");
+        texit(0);
+    }
+    Value *vector = vectorArg(car(args), "vector-set!");
+    uint32_t index = indexArg(car(cdr(args)), vector -> vec -> length, "vector-set!");
+    vectorSet(vector, index, car(cdr(cdr(args))));
+    return VOID_VALUE;
+}
+
+/*
+primitiveVectorLength
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to an integer-type Value holding the number of items in the given vector
+*/
+Value *primitiveVectorLength(Value *args) {
+    if (length(args) != 1) {
+        printf("Evaluation error: incorrect number of args for 'vector-length'\n");
+        texit(0);
+    }
+    return makeInt(vectorArg(car(args), "vector-length") -> vec -> length);
+}
+
+/*
+primitiveVectorFill
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a void-type Value
+primitiveVectorFill() replaces every item of the given vector with the given Value.
+*/
+Value *primitiveVectorFill(Value *args) {
+    if (length(args) != 2) {
+        printf("Evaluation error: incorrect number of args for 'vector-fill!'\n");
+        texit(0);
+    }
+    Value *vector = vectorArg(car(args), "vector-fill!");
+    for (uint32_t i = 0; i < vector -> vec -> length; i++) {
+        vectorSet(vector, i, car(cdr(args)));
+    }
+    return VOID_VALUE;
+}
+
+/*
+primitiveVectorToList
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a new list holding the items of the given vector, in order
+*/
+Value *primitiveVectorToList(Value *args) {
+    if (length(args) != 1) {
+        printf("Evaluation error: incorrect number of args for 'vector->list'\n");
+        texit(0);
+    }
+    Value *vector = vectorArg(car(args), "vector->list");
+    Value *list = makeNull();
+    for (uint32_t i = vector -> vec -> length; i > 0; i--) {
+        list = cons(vectorRef(vector, i - 1), list);
+    }
+    return list;
+}
+
+/*
+primitiveListToVector
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a new vector-type Value holding the items of the given list, in order
+primitiveListToVector() throws an error if it is not given exactly one proper list.
+*/
+Value *primitiveListToVector(Value *args) {
+    if (length(args) != 1) {
+        printf("Evaluation error: incorrect number of args for 'list->vector'\n");
+        texit(0);
+    }
+    Value *current = car(args);
+    while (typeOf(current) == CONS_TYPE) {
+        current = cdr(current);
+    }
+    if (typeOf(current) != NULL_TYPE) {
+        printf("Evaluation error: argument to list->vector is not a list\n");
+        texit(0);
+    }
+    return primitiveVector(car(args));
+}
+
+/*
+hashTableArg
+params: arg - a pointer to a Value, name - the name of the primitive it was passed to
+returns: arg, once it is known to be a hash table
+hashTableArg() throws an error if arg is not a hash table.
+*/
+Value *hashTableArg(Value *arg, char *name) {
+    if (typeOf(arg) != HASH_TYPE) {
+        printf("Evaluation error: argument to %s is not a hash table\n", name);
+        texit(0);
+    }
+    return arg;
+}
+
+/*
+primitiveEqualp
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a boolean-type Value
+primitiveEqualp() returns true if its two arguments are the same number, string or symbol, or lists or vectors whose
+items are equal? to each other.
+*/
+Value *primitiveEqualp(Value *args) {
+    if (length(args) != 2) {
+        printf("Evaluation error: incorrect number of args for 'equal?'\n");
+        texit(0);
+    }
+    return valuesEqual(car(args), car(cdr(args))) ? TRUE_VALUE : FALSE_VALUE;
+}
+
+/*
+primitiveMakeHashTable
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a new, empty hash-table-type Value, whose keys are compared with equal?
+*/
+Value *primitiveMakeHashTable(Value *args) {
+    if (typeOf(args) != NULL_TYPE) {
+        printf("Evaluation error: incorrect number of args for 'make-hash-table'\n");
+        texit(0);
+    }
+    return makeHashTable();
+}
+
+/*
+primitiveHashTablep
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a boolean-type Value, true if the argument is a hash table
+*/
+Value *primitiveHashTablep(Value *args) {
+    if (length(args) != 1) {
+        printf("Evaluation error: incorrect number of args for 'hash-table?'\n");
+        texit(0);
+    }
+    return typeOf(car(args)) == HASH_TYPE ? TRUE_VALUE : FALSE_VALUE;
+}
+
+/*
+primitiveHashTableSet
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a void-type Value
+primitiveHashTableSet() stores the given value under the given key in the given hash table.
+*/
+Value *primitiveHashTableSet(Value *args) {
+    if (length(args) != 3) {
+        printf("Evaluation error: incorrect number of args for 'hash-table-set!'\n");
+        texit(0);
+    }
+    hashTableSet(hashTableArg(car(args), "hash-table-set!"), car(cdr(args)), car(cdr(cdr(args))));
+    return VOID_VALUE;
+}
+
+/*
+primitiveHashTableRef
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to the Value stored under the given key in the given hash table
+primitiveHashTableRef() calls the optional third argument with no arguments, and returns what it returns, if the key
+isn't in the table, and throws an error if the key isn't in the table and there is no third argument.
+*/
+Value *primitiveHashTableRef(Value *args) {
+    if (length(args) != 2 && length(args) != 3) {
+        printf("Evaluation error: incorrect number of args for 'hash-table-ref'\n");
+        texit(0);
+    }
+    Value *found = hashTableRef(hashTableArg(car(args), "hash-table-ref"), car(cdr(args)));
+    if (found != NULL) {
+        return found;
+    }
+    if (length(args) == 2) {
+        printf("Evaluation error: key not found in hash table\n");
+        texit(0);
+    }
+    return apply(car(cdr(cdr(args))), makeNull());
+}
+
+/*
+primitiveHashTableRefDefault
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to the Value stored under the given key in the given hash table, or the given default if there
+isn't one
+*/
+Value *primitiveHashTableRefDefault(Value *args) {
+    if (length(args) != 3) {
+        printf("Evaluation error: incorrect number of args for 'hash-table-ref/default'\n");
+        texit(0);
+    }
+    Value *found = hashTableRef(hashTableArg(car(args), "hash-table-ref/default"), car(cdr(args)));
+    return found != NULL ? found : car(cdr(cdr(args)));
+}
+
+/*
+primitiveHashTableContains
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a boolean-type Value, true if the given key is in the given hash table
+*/
+Value *primitiveHashTableContains(Value *args) {
+    if (length(args) != 2) {
+        printf("Evaluation error: incorrect number of args for 'hash-table-contains?'\n");
+        texit(0);
+    }
+    Value *found = hashTableRef(hashTableArg(car(args), "hash-table-contains?"), car(cdr(args)));
+    return found != NULL ? TRUE_VALUE : FALSE_VALUE;
+}
+
+/*
+primitiveHashTableDelete
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a void-type Value
+primitiveHashTableDelete() removes the given key from the given hash table, if it is there.
+*/
+Value *primitiveHashTableDelete(Value *args) {
+    if (length(args) != 2) {
+        printf("Evaluation error: incorrect number of args for 'hash-table-delete!'\n");
+        texit(0);
+    }
+    hashTableDelete(hashTableArg(car(args), "hash-table-delete!"), car(cdr(args)));
+    return VOID_VALUE;
+}
+
+/*
+primitiveHashTableCount
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to an integer-type Value holding the number of entries in the given hash table
+*/
+Value *primitiveHashTableCount(Value *args) {
+    if (length(args) != 1) {
+        printf("Evaluation error: incorrect number of args for 'hash-table-count'\n");
+        texit(0);
+    }
+    return makeInt(hashTableArg(car(args), "hash-table-count") -> ht -> count);
+}
+
+/*
+primitiveHashTableToAlist
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a new list of (key . value) pairs, one for each entry in the given hash table
+*/
+Value *primitiveHashTableToAlist(Value *args) {
+    if (length(args) != 1) {
+        printf("Evaluation error: incorrect number of args for 'hash-table->alist'\n");
+        texit(0);
+    }
+    return hashTableEntries(hashTableArg(car(args), "hash-table->alist"));
+}
+
+/*
+primitiveHashTableKeys
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a new list of the keys in the given hash table
+*/
+Value *primitiveHashTableKeys(Value *args) {
+    if (length(args) != 1) {
+        printf("Evaluation error: incorrect number of args for 'hash-table-keys'\n");
+        texit(0);
+    }
+    Value *keys = makeNull();
+    Value *entries = hashTableEntries(hashTableArg(car(args), "hash-table-keys"));
+    for (; typeOf(entries) != NULL_TYPE; entries = cdr(entries)) {
+        keys = cons(car(car(entries)), keys);
+    }
+    return keys;
+}
+
+/*
+primitiveHashTableValues
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a new list of the values in the given hash table
+*/
+Value *primitiveHashTableValues(Value *args) {
+    if (length(args) != 1) {
+        printf("Evaluation error: incorrect number of args for 'hash-table-values'\n");
+        texit(0);
+    }
+    Value *values = makeNull();
+    Value *entries = hashTableEntries(hashTableArg(car(args), "hash-table-values"));
+    for (; typeOf(entries) != NULL_TYPE; entries = cdr(entries)) {
+        values = cons(cdr(car(entries)), values);
+    }
+    return values;
+}
+
+/*
+primitiveHashTableWalk
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a void-type Value
+primitiveHashTableWalk() calls the given procedure with each key in the given hash table and its value. The entries
+are collected before the first call, so the procedure may change the table.
+*/
+Value *primitiveHashTableWalk(Value *args) {
+    if (length(args) != 2) {
+        printf("Evaluation error: incorrect number of args for 'hash-table-walk'\n");
+        texit(0);
+    }
+    Value *entries = hashTableEntries(hashTableArg(car(args), "hash-table-walk"));
+    Value *procedure = car(cdr(args));
+    gcPushValue(&entries);
+    gcPushValue(&procedure);
+    for (; typeOf(entries) != NULL_TYPE; entries = cdr(entries)) {
+        Value *entry = car(entries);
+        apply(procedure, cons(car(entry), cons(cdr(entry), makeNull())));
+    }
+    gcPop(2);
+    return VOID_VALUE;
+}
+
+/*
+numericVectorArg
+params: arg - a pointer to a Value, type - F64VECTOR_TYPE or S64VECTOR_TYPE, name - the name of the primitive
+returns: arg, once it is known to be a vector of that type
+numericVectorArg() throws an error if arg is not a vector of the given type.
+*/
+Value *numericVectorArg(Value *arg, valueType type, char *name) {
+    if (typeOf(arg) != type) {
+        printf("Evaluation error: argument to %s is not an %s\n", name, type == F64VECTOR_TYPE ? "f64vector" : "s64vector");
+        texit(0);
+    }
+    return arg;
+}
+
+/*
+numericVectorLength
+params: vector - a pointer to an f64vector-type or s64vector-type Value
+returns: the number of items in it
+*/
+uint32_t numericVectorLength(Value *vector) {
+    if (typeOf(vector) == F64VECTOR_TYPE) {
+        return (uint32_t)vector -> f64v -> length;
+    }
+    return (uint32_t)vector -> s64v -> length;
+}
+
+/*
+makeNumericVector
+params: type - F64VECTOR_TYPE or S64VECTOR_TYPE, length - the number of items
+returns: a pointer to a new vector of that type, filled with zeros
+*/
+Value *makeNumericVector(valueType type, uint32_t length) {
+    return type == F64VECTOR_TYPE ? makeF64Vector(length) : makeS64Vector(length);
+}
+
+/*
+numericItem
+params: vector - a pointer to an f64vector-type or s64vector-type Value, index - which item to get
+returns: a pointer to a new double-type or integer-type Value holding the item
+*/
+Value *numericItem(Value *vector, uint32_t index) {
+    if (typeOf(vector) == F64VECTOR_TYPE) {
+        return makeDouble(vector -> f64v -> items[index]);
+    }
+    return makeInt(vector -> s64v -> items[index]);
+}
+
+/*
+setNumericItem
+params: vector - a pointer to an f64vector-type or s64vector-type Value, index - which item to set, item - a pointer to
+a Value holding the new number, name - the name of the primitive
+returns: nothing
+setNumericItem() throws an error if item is not a number, or, for an s64vector, not an integer that fits in 64 bits.
+*/
+void setNumericItem(Value *vector, uint32_t index, Value *item, char *name) {
+    if (typeOf(vector) == F64VECTOR_TYPE && isNumber(item)) {
+        vector -> f64v -> items[index] = numberToDouble(item);
+    } else if (typeOf(vector) == S64VECTOR_TYPE && typeOf(item) == INT_TYPE) {
+        vector -> s64v -> items[index] = intOf(item);
+    } else {
+        printf("Evaluation error: %s given a number that doesn't fit\n", name);
+        texit(0);
+    }
+}
+
+/*
+numericMake
+params: args - a pointer to a Value representing a linked list of arguments, type - the type of vector to make,
+name - the name of the primitive
+returns: a pointer to a new vector of the given length, with every item the optional fill value, or zero
+*/
+Value *numericMake(Value *args, valueType type, char *name) {
+    if (length(args) != 1 && length(args) != 2) {
+        printf("Evaluation error: incorrect number of args for '%s'\n", name);
+        texit(0);
+    }
+    Value *vector = makeNumericVector(type, indexArg(car(args), UINT32_MAX, name));
+    for (uint32_t i = 0; length(args) == 2 && i < numericVectorLength(vector); i++) {
+        setNumericItem(vector, i, car(cdr(args)), name);
+    }
+    return vector;
+}
+
+/*
+numericFromList
+params: list - a pointer to a Value representing a list of numbers, type - the type of vector to make, name - the
+name of the primitive
+returns: a pointer to a new vector of the given type holding the numbers in list, in order
+numericFromList() throws an error if list is not a proper list of numbers that fit in the vector.
+*/
+Value *numericFromList(Value *list, valueType type, char *name) {
+    uint32_t count = 0;
+    Value *current = list;
+    for (; typeOf(current) == CONS_TYPE; current = cdr(current)) {
+        count++;
+    }
+    if (typeOf(current) != NULL_TYPE) {
+        printf("Evaluation error: argument to %s is not a list\n", name);
+        texit(0);
+    }
+    Value *vector = makeNumericVector(type, count);
+    for (uint32_t i = 0; i < count; i++) {
+        setNumericItem(vector, i, car(list), name);
+        list = cdr(list);
+    }
+    return vector;
+}
+
+/*
+numericLength, numericRef, numericSet, numericToList
+params: args - a pointer to a Value representing a linked list of arguments, type - the type of vector expected,
+name - the name of the primitive
+returns: the number of items in the vector; the item at the given index; a void-type Value, after replacing the item
+at the given index; a new list of the vector's items
+These throw an error if given the wrong number or kind of arguments, or an index that is out of range.
+*/
+Value *numericLength(Value *args, valueType type, char *name) {
+    if (length(args) != 1) {
+        printf("Evaluation error: incorrect number of args for '%s'\n", name);
+        texit(0);
+    }
+    return makeInt(numericVectorLength(numericVectorArg(car(args), type, name)));
+}
+
+Value *numericRef(Value *args, valueType type, char *name) {
+    if (length(args) != 2) {
+        printf("Evaluation error: incorrect number of args for '%s'\n", name);
+        texit(0);
+    }
+    Value *vector = numericVectorArg(car(args), type, name);
+    return numericItem(vector, indexArg(car(cdr(args)), numericVectorLength(vector), name));
+}
+
+Value *numericSet(Value *args, valueType type, char *name) {
+    if (length(args) != 3) {
+        printf("Evaluation error: incorrect number of args for '%s'\n", name);
+        texit(0);
+    }
+    Value *vector = numericVectorArg(car(args), type, name);
+    uint32_t index = indexArg(car(cdr(args)), numericVectorLength(vector), name);
+    setNumericItem(vector, index, car(cdr(cdr(args))), name);
+    return VOID_VALUE;
+}
+
+Value *numericToList(Value *args, valueType type, char *name) {
+    if (length(args) != 1) {
+        printf("Evaluation error: incorrect number of args for '%s'\n", name);
+        texit(0);
+    }
+    Value *vector = numericVectorArg(car(args), type, name);
+    Value *list = makeNull();
+    for (uint32_t i = numericVectorLength(vector); i > 0; i--) {
+        list = cons(numericItem(vector, i - 1), list);
+    }
+    return list;
+}
+
+/*
+numericElementwise
+params: args - a pointer to a Value representing a linked list of arguments, type - the type of vector expected,
+name - the name of the primitive, multiply - true to multiply the items, false to add them
+returns: a pointer to a new vector holding the sums (or products) of the two given vectors' items
+numericElementwise() throws an error if the vectors are of different lengths, or if a result doesn't fit in an
+s64vector.
+*/
+Value *numericElementwise(Value *args, valueType type, char *name, bool multiply) {
+    if (length(args) != 2) {
+        printf("Evaluation error: incorrect number of args for '%s'\n", name);
+        texit(0);
+    }
+    Value *a = numericVectorArg(car(args), type, name);
+    Value *b = numericVectorArg(car(cdr(args)), type, name);
+    uint32_t count = numericVectorLength(a);
+    if (numericVectorLength(b) != count) {
+        printf("Evaluation error: vectors given to %s have different lengths\n", name);
+        texit(0);
+    }
+    Value *result = makeNumericVector(type, count);
+    bool fits = true;
+    if (type == F64VECTOR_TYPE && multiply) {
+        f64Multiply(result -> f64v -> items, a -> f64v -> items, b -> f64v -> items, count);
+    } else if (type == F64VECTOR_TYPE) {
+        f64Add(result -> f64v -> items, a -> f64v -> items, b -> f64v -> items, count);
+    } else if (multiply) {
+        fits = s64Multiply(result -> s64v -> items, a -> s64v -> items, b -> s64v -> items, count);
+    } else {
+        fits = s64Add(result -> s64v -> items, a -> s64v -> items, b -> s64v -> items, count);
+    }
+    if (!fits) {
+        printf("Evaluation error: result of %s doesn't fit in an s64vector\n", name);
+        texit(0);
+    }
+    return result;
+}
+
+/*
+numericScale
+params: args - a pointer to a Value representing a linked list of arguments, type - the type of vector expected,
+name - the name of the primitive
+returns: a pointer to a new vector holding the given vector's items times the given number
+numericScale() throws an error if the number, or a result, doesn't fit in an s64vector.
+*/
+Value *numericScale(Value *args, valueType type, char *name) {
+    if (length(args) != 2) {
+        printf("Evaluation error: incorrect number of args for '%s'\n", name);
+        texit(0);
+    }
+    Value *vector = numericVectorArg(car(args), type, name);
+    Value *factor = car(cdr(args));
+    uint32_t count = numericVectorLength(vector);
+    Value *result = makeNumericVector(type, count);
+    if (type == F64VECTOR_TYPE && isNumber(factor)) {
+        f64Scale(result -> f64v -> items, vector -> f64v -> items, numberToDouble(factor), count);
+    } else if (type != S64VECTOR_TYPE || typeOf(factor) != INT_TYPE
+               || !s64Scale(result -> s64v -> items, vector -> s64v -> items, intOf(factor), count)) {
+        printf("Evaluation error: result of %s doesn't fit in an s64vector\n", name);
+        texit(0);
+    }
+    return result;
+}
+
+/*
+numericSum
+params: args - a pointer to a Value representing a linked list of arguments, type - the type of vector expected,
+name - the name of the primitive
+returns: a pointer to a Value holding the sum of the given vector's items
+An s64vector's sum is exact: if it doesn't fit in 64 bits, it is worked out again with bignums.
+*/
+Value *numericSum(Value *args, valueType type, char *name) {
+    if (length(args) != 1) {
+        printf("Evaluation error: incorrect number of args for '%s'\n", name);
+        texit(0);
+    }
+    Value *vector = numericVectorArg(car(args), type, name);
+    uint32_t count = numericVectorLength(vector);
+    if (type == F64VECTOR_TYPE) {
+        return makeDouble(f64Sum(vector -> f64v -> items, count));
+    }
+    int64_t sum;
+    if (s64Sum(&sum, vector -> s64v -> items, count)) {
+        return makeInt(sum);
+    }
+    Value *total = makeInt(0);
+    for (uint32_t i = 0; i < count; i++) {
+        total = integerAdd(total, makeInt(vector -> s64v -> items[i]));
+    }
+    return total;
+}
+
+/*
+numericDot
+params: args - a pointer to a Value representing a linked list of arguments, type - the type of vector expected,
+name - the name of the primitive
+returns: a pointer to a Value holding the sum of the products of the two given vectors' items
+numericDot() throws an error if the vectors are of different lengths. Like numericSum, it is exact for s64vectors.
+*/
+Value *numericDot(Value *args, valueType type, char *name) {
+    if (length(args) != 2) {
+        printf("Evaluation error: incorrect number of args for '%s'\n", name);
+        texit(0);
+    }
+    Value *a = numericVectorArg(car(args), type, name);
+    Value *b = numericVectorArg(car(cdr(args)), type, name);
+    uint32_t count = numericVectorLength(a);
+    if (numericVectorLength(b) != count) {
+        printf("Evaluation error: vectors given to %s have different lengths\n", name);
+        texit(0);
+    }
+    if (type == F64VECTOR_TYPE) {
+        return makeDouble(f64Dot(a -> f64v -> items, b -> f64v -> items, count));
+    }
+    int64_t dot;
+    if (s64Dot(&dot, a -> s64v -> items, b -> s64v -> items, count)) {
+        return makeInt(dot);
+    }
+    Value *total = makeInt(0);
+    for (uint32_t i = 0; i < count; i++) {
+        Value *product = integerMultiply(makeInt(a -> s64v -> items[i]), makeInt(b -> s64v -> items[i]));
+        total = integerAdd(total, product);
+    }
+    return total;
+}
+
+/*
+numericExtreme
+params: args - a pointer to a Value representing a linked list of arguments, type - the type of vector expected,
+name - the name of the primitive, largest - true for the largest item, false for the smallest
+returns: a pointer to a Value holding the smallest (or largest) of the given vector's items
+numericExtreme() throws an error if the vector is empty.
+*/
+Value *numericExtreme(Value *args, valueType type, char *name, bool largest) {
+    if (length(args) != 1) {
+        printf("Evaluation error: incorrect number of args for '%s'\n", name);
+        texit(0);
+    }
+    Value *vector = numericVectorArg(car(args), type, name);
+    uint32_t count = numericVectorLength(vector);
+    if (count == 0) {
+        printf("Evaluation error: %s given an empty vector\n", name);
+        texit(0);
+    }
+    if (type == F64VECTOR_TYPE) {
+        double *items = vector -> f64v -> items;
+        return makeDouble(largest ? f64Max(items, count) : f64Min(items, count));
+    }
+    int64_t *items = vector -> s64v -> items;
+    return makeInt(largest ? s64Max(items, count) : s64Min(items, count));
+}
+
+/*
+primitiveMakeF64Vector, primitiveMakeS64Vector
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a new vector of the given length, every item the optional fill value or zero
+The Scheme make-f64vector, make-s64vector.
+*/
+Value *primitiveMakeF64Vector(Value *args) {
+    return numericMake(args, F64VECTOR_TYPE, "make-f64vector");
+}
+
+Value *primitiveMakeS64Vector(Value *args) {
+    return numericMake(args, S64VECTOR_TYPE, "make-s64vector");
+}
+
+/*
+primitiveF64Vector, primitiveS64Vector
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a new vector holding the arguments, in order
+The Scheme f64vector, s64vector.
+*/
+Value *primitiveF64Vector(Value *args) {
+    return numericFromList(args, F64VECTOR_TYPE, "f64vector");
+}
+
+Value *primitiveS64Vector(Value *args) {
+    return numericFromList(args, S64VECTOR_TYPE, "s64vector");
+}
+
+/*
+primitiveF64VectorLength, primitiveS64VectorLength
+params: args - a pointer to a Value representing a linked list of arguments
+returns: the number of items in the vector
+The Scheme f64vector-length, s64vector-length.
+*/
+Value *primitiveF64VectorLength(Value *args) {
+    return numericLength(args, F64VECTOR_TYPE, "f64vector-length");
+}
+
+Value *primitiveS64VectorLength(Value *args) {
+    return numericLength(args, S64VECTOR_TYPE, "s64vector-length");
+}
+
+/*
+primitiveF64VectorRef, primitiveS64VectorRef
+params: args - a pointer to a Value representing a linked list of arguments
+returns: the item at the given index
+The Scheme f64vector-ref, s64vector-ref.
+*/
+Value *primitiveF64VectorRef(Value *args) {
+    return numericRef(args, F64VECTOR_TYPE, "f64vector-ref");
+}
+
+Value *primitiveS64VectorRef(Value *args) {
+    return numericRef(args, S64VECTOR_TYPE, "s64vector-ref");
+}
+
+/*
+primitiveF64VectorSet, primitiveS64VectorSet
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a void-type Value, after replacing the item at the given index
+The Scheme f64vector-set!, s64vector-set!.
+*/
+Value *primitiveF64VectorSet(Value *args) {
+    return numericSet(args, F64VECTOR_TYPE, "f64vector-set!");
+}
+
+Value *primitiveS64VectorSet(Value *args) {
+    return numericSet(args, S64VECTOR_TYPE, "s64vector-set!");
+}
+
+/*
+primitiveF64VectorToList, primitiveS64VectorToList
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a new list of the vector's items
+The Scheme f64vector->list, s64vector->list.
+*/
+Value *primitiveF64VectorToList(Value *args) {
+    return numericToList(args, F64VECTOR_TYPE, "f64vector->list");
+}
+
+Value *primitiveS64VectorToList(Value *args) {
+    return numericToList(args, S64VECTOR_TYPE, "s64vector->list");
+}
+
+/*
+primitiveF64VectorAdd, primitiveS64VectorAdd
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a new vector of the sums of two vectors' items
+The Scheme f64vector-add, s64vector-add.
+*/
+Value *primitiveF64VectorAdd(Value *args) {
+    return numericElementwise(args, F64VECTOR_TYPE, "f64vector-add", false);
+}
+
+Value *primitiveS64VectorAdd(Value *args) {
+    return numericElementwise(args, S64VECTOR_TYPE, "s64vector-add", false);
+}
+
+/*
+primitiveF64VectorMultiply, primitiveS64VectorMultiply
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a new vector of the products of two vectors' items
+The Scheme f64vector-mul, s64vector-mul.
+*/
+Value *primitiveF64VectorMultiply(Value *args) {
+    return numericElementwise(args, F64VECTOR_TYPE, "f64vector-mul", true);
+}
+
+Value *primitiveS64VectorMultiply(Value *args) {
+    return numericElementwise(args, S64VECTOR_TYPE, "s64vector-mul", true);
+}
+
+/*
+primitiveF64VectorScale, primitiveS64VectorScale
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a new vector of the vector's items times a number
+The Scheme f64vector-scale, s64vector-scale.
+*/
+Value *primitiveF64VectorScale(Value *args) {
+    return numericScale(args, F64VECTOR_TYPE, "f64vector-scale");
+}
+
+Value *primitiveS64VectorScale(Value *args) {
+    return numericScale(args, S64VECTOR_TYPE, "s64vector-scale");
+}
+
+/*
+primitiveF64VectorSum, primitiveS64VectorSum
+params: args - a pointer to a Value representing a linked list of arguments
+returns: the sum of the vector's items
+The Scheme f64vector-sum, s64vector-sum.
+*/
+Value *primitiveF64VectorSum(Value *args) {
+    return numericSum(args, F64VECTOR_TYPE, "f64vector-sum");
+}
+
+Value *primitiveS64VectorSum(Value *args) {
+    return numericSum(args, S64VECTOR_TYPE, "s64vector-sum");
+}
+
+/*
+primitiveF64VectorDot, primitiveS64VectorDot
+params: args - a pointer to a Value representing a linked list of arguments
+returns: the sum of the products of two vectors' items
+The Scheme f64vector-dot, s64vector-dot.
+*/
+Value *primitiveF64VectorDot(Value *args) {
+    return numericDot(args, F64VECTOR_TYPE, "f64vector-dot");
+}
+
+Value *primitiveS64VectorDot(Value *args) {
+    return numericDot(args, S64VECTOR_TYPE, "s64vector-dot");
+}
+
+/*
+primitiveF64VectorMin, primitiveS64VectorMin
+params: args - a pointer to a Value representing a linked list of arguments
+returns: the smallest of the vector's items
+The Scheme f64vector-min, s64vector-min.
+*/
+Value *primitiveF64VectorMin(Value *args) {
+    return numericExtreme(args, F64VECTOR_TYPE, "f64vector-min", false);
+}
+
+Value *primitiveS64VectorMin(Value *args) {
+    return numericExtreme(args, S64VECTOR_TYPE, "s64vector-min", false);
+}
+
+/*
+primitiveF64VectorMax, primitiveS64VectorMax
+params: args - a pointer to a Value representing a linked list of arguments
+returns: the largest of the vector's items
+The Scheme f64vector-max, s64vector-max.
+*/
+Value *primitiveF64VectorMax(Value *args) {
+    return numericExtreme(args, F64VECTOR_TYPE, "f64vector-max", true);
+}
+
+Value *primitiveS64VectorMax(Value *args) {
+    return numericExtreme(args, S64VECTOR_TYPE, "s64vector-max", true);
+}
+
+/*
+primitiveF64Vectorp, primitiveS64Vectorp
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a boolean-type Value, true if the argument is an f64vector (or s64vector)
+*/
+Value *primitiveF64Vectorp(Value *args) {
+    if (length(args) != 1) {
+        printf("Evaluation error: incorrect number of args for 'f64vector?'\n");
+        texit(0);
+    }
+    return typeOf(car(args)) == F64VECTOR_TYPE ? TRUE_VALUE : FALSE_VALUE;
+}
+
+Value *primitiveS64Vectorp(Value *args) {
+    if (length(args) != 1) {
+        printf("Evaluation error: incorrect number of args for 's64vector?'\n");
+        texit(0);
+    }
+    return typeOf(car(args)) == S64VECTOR_TYPE ? TRUE_VALUE : FALSE_VALUE;
+}
+
+/*
+primitiveListToF64Vector, primitiveListToS64Vector
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a new vector holding the numbers in the given list, in order
+*/
+Value *primitiveListToF64Vector(Value *args) {
+    if (length(args) != 1) {
+        printf("Evaluation error: incorrect number of args for 'list->f64vector'\n");
+        texit(0);
+    }
+    return numericFromList(car(args), F64VECTOR_TYPE, "list->f64vector");
+}
+
+Value *primitiveListToS64Vector(Value *args) {
+    if (length(args) != 1) {
+        printf("Evaluation error: incorrect number of args for 'list->s64vector'\n");
+        texit(0);
+    }
+    return numericFromList(car(args), S64VECTOR_TYPE, "list->s64vector");
+}
+
+/*
+bytevectorArg
+params: arg - a pointer to a Value, name - the name of the primitive it was passed to
+returns: arg, once it is known to be a bytevector
+bytevectorArg() throws an error if arg is not a bytevector.
+*/
+Value *bytevectorArg(Value *arg, char *name) {
+    if (typeOf(arg) != BYTEVECTOR_TYPE) {
+        printf("Evaluation error: argument to %s is not a bytevector\n", name);
+        texit(0);
+    }
+    return arg;
+}
+
+/*
+byteIndexArg
+params: arg - a pointer to a Value, bytevector - a pointer to a bytevector-type Value, width - the number of bytes
+to be read or written, name - the name of the primitive
+returns: arg as an index
+byteIndexArg() throws an error if arg is not an integer, or if the width bytes starting there aren't all in bytevector.
+*/
+uint64_t byteIndexArg(Value *arg, Value *bytevector, int width, char *name) {
+    uint64_t length = bytevector -> bv -> length;
+    if (typeOf(arg) != INT_TYPE || intOf(arg) < 0 || length < (uint64_t)width || (uint64_t)intOf(arg) > length - width) {
+        printf("Evaluation error: index out of range for '%s'\n", name);
+        texit(0);
+    }
+    return (uint64_t)intOf(arg);
+}
+
+/*
+bigEndianArg
+params: args - a pointer to a Value representing the list of arguments left after the index (and value), name - the
+name of the primitive
+returns: true if they are the symbol big, false if they are the symbol little or there are none
+bigEndianArg() throws an error for anything else.
+*/
+bool bigEndianArg(Value *args, char *name) {
+    if (typeOf(args) == NULL_TYPE) {
+        return false;
+    }
+    Value *order = car(args);
+    if (typeOf(cdr(args)) != NULL_TYPE || typeOf(order) != SYMBOL_TYPE
+        || (strcmp(order -> s, "big") != 0 && strcmp(order -> s, "little") != 0)) {
+        printf("Evaluation error: '%s' expects the symbol big or little as its last argument\n", name);
+        texit(0);
+    }
+    return strcmp(order -> s, "big") == 0;
+}
+
+/*
+bytevectorRef
+params: args - a pointer to a Value representing a linked list of arguments, width - the size of the number in bytes,
+isSigned - whether it is signed, name - the name of the primitive
+returns: a pointer to an integer-type Value holding the number at the given index, in the optional byte order
+(little-endian unless the symbol big is given)
+*/
+Value *bytevectorRef(Value *args, int width, bool isSigned, char *name) {
+    int count = length(args);
+    if (count != 2 && (width == 1 || count != 3)) {
+        printf("Evaluation error: incorrect number of args for '%s'\n", name);
+        texit(0);
+    }
+    Value *bytevector = bytevectorArg(car(args), name);
+    uint64_t index = byteIndexArg(car(cdr(args)), bytevector, width, name);
+    uint64_t bits = bytevectorGet(bytevector, index, width, bigEndianArg(cdr(cdr(args)), name));
+    if (isSigned) {
+        // shift the sign bit up to the top and back down again, to extend it
+        int unused = 64 - 8 * width;
+        return makeInt((int64_t)(bits << unused) >> unused);
+    }
+    return integerFromUnsigned(bits);
+}
+
+/*
+bytevectorSet
+params: args - a pointer to a Value representing a linked list of arguments, width - the size of the number in bytes,
+isSigned - whether it is signed, name - the name of the primitive
+returns: a pointer to a void-type Value, after storing the given number at the given index, in the optional byte order
+bytevectorSet() throws an error if the number doesn't fit in width bytes, or the bytevector came from a file.
+*/
+Value *bytevectorSet(Value *args, int width, bool isSigned, char *name) {
+    int count = length(args);
+    if (count != 3 && (width == 1 || count != 4)) {
+        printf("Evaluation error: incorrect number of args for '%s'\n", name);
+        texit(0);
+    }
+    Value *bytevector = bytevectorArg(car(args), name);
+    if (bytevector -> bv -> readOnly) {
+        printf("Evaluation error: '%s' given a read-only bytevector\n", name);
+        texit(0);
+    }
+    uint64_t index = byteIndexArg(car(cdr(args)), bytevector, width, name);
+    Value *number = car(cdr(cdr(args)));
+    uint64_t bits;
+    bool fits;
+    if (isSigned) {
+        int64_t limit = (int64_t)((UINT64_MAX >> (64 - 8 * width)) >> 1);
+        fits = typeOf(number) == INT_TYPE && intOf(number) <= limit && intOf(number) >= -limit - 1;
+        bits = fits ? (uint64_t)intOf(number) : 0;
+    } else {
+        fits = (typeOf(number) == INT_TYPE || typeOf(number) == BIGNUM_TYPE) && integerToUnsigned(number, &bits)
+            && bits <= UINT64_MAX >> (64 - 8 * width);
+    }
+    if (!fits) {
+        printf("Evaluation error: %s given a number that doesn't fit\n", name);
+        texit(0);
+    }
+    bytevectorPut(bytevector, index, width, bigEndianArg(cdr(cdr(cdr(args))), name), bits);
+    return VOID_VALUE;
+}
+
+/*
+primitiveMakeBytevector
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a new bytevector of the given length, every byte the optional fill value, or 0
+*/
+Value *primitiveMakeBytevector(Value *args) {
+    if (length(args) != 1 && length(args) != 2) {
+        printf("Evaluation error: incorrect number of args for 'make-bytevector'\n");
+        texit(0);
+    }
+    Value *count = car(args);
+    if (typeOf(count) != INT_TYPE || intOf(count) < 0) {
+        printf("Evaluation error: index out of range for 'make-bytevector'\n");
+        texit(0);
+    }
+    Value *fill = length(args) == 2 ? car(cdr(args)) : makeInt(0);
+    if (typeOf(fill) != INT_TYPE || intOf(fill) < 0 || intOf(fill) > UINT8_MAX) {
+        printf("Evaluation error: make-bytevector given a number that doesn't fit\n");
+        texit(0);
+    }
+    Value *bytevector = makeBytevector((uint64_t)intOf(count));
+    memset(bytevector -> bv -> bytes, (int)intOf(fill), bytevector -> bv -> length);
+    return bytevector;
+}
+
+/*
+primitiveBytevector
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a new bytevector holding the arguments, each of which must be from 0 to 255, in order
+*/
+Value *primitiveBytevector(Value *args) {
+    Value *bytevector = makeBytevector(length(args));
+    for (uint64_t i = 0; typeOf(args) == CONS_TYPE; i++) {
+        Value *byte = car(args);
+        if (typeOf(byte) != INT_TYPE || intOf(byte) < 0 || intOf(byte) > UINT8_MAX) {
+            printf("Evaluation error: bytevector given a number that doesn't fit\n");
+            texit(0);
+        }
+        bytevectorPut(bytevector, i, 1, false, (uint64_t)intOf(byte));
+        args = cdr(args);
+    }
+    return bytevector;
+}
+
+/*
+primitiveBytevectorp
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a boolean-type Value, true if the argument is a bytevector
+*/
+Value *primitiveBytevectorp(Value *args) {
+    if (length(args) != 1) {
+        printf("Evaluation error: incorrect number of args for 'bytevector?'\n");
+        texit(0);
+    }
+    return typeOf(car(args)) == BYTEVECTOR_TYPE ? TRUE_VALUE : FALSE_VALUE;
+}
+
+/*
+primitiveBytevectorLength
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to an integer-type Value holding the number of bytes in the given bytevector
+*/
+Value *primitiveBytevectorLength(Value *args) {
+    if (length(args) != 1) {
+        printf("Evaluation error: incorrect number of args for 'bytevector-length'\n");
+        texit(0);
+    }
+    return integerFromUnsigned(bytevectorArg(car(args), "bytevector-length") -> bv -> length);
+}
+
+/*
+primitiveFileToBytevector
+params: args - a pointer to a Value representing a linked list of arguments
+returns: a pointer to a new, read-only bytevector holding the contents of the file named by the given string
+primitiveFileToBytevector() throws an error if the file can't be read. The file is mapped into memory, not copied.
+*/
+Value *primitiveFileToBytevector(Value *args) {
+    if (length(args) != 1 || typeOf(car(args)) != STR_TYPE) {
+        printf("Evaluation error: 'file->bytevector' expects one string\n");
+        texit(0);
+    }
+    Value *bytevector = fileToBytevector(stringChars(car(args)));
+    if (bytevector == NULL) {
+        printf("Evaluation error: can't read file \"%s\"\n", stringChars(car(args)));
+        texit(0);
+    }
+    return bytevector;
+}
+
+/*
+primitiveBytevectorU8Ref, primitiveBytevectorU8Set
+params: args - a pointer to a Value representing a linked list of arguments
+returns: the unsigned 8-bit integer at the given index; a void-type Value, after storing one there
+*/
+Value *primitiveBytevectorU8Ref(Value *args) {
+    return bytevectorRef(args, 1, false, "bytevector-u8-ref");
+}
+
+Value *primitiveBytevectorU8Set(Value *args) {
+    return bytevectorSet(args, 1, false, "bytevector-u8-set!");
+}
+
+/*
+primitiveBytevectorS8Ref, primitiveBytevectorS8Set
+params: args - a pointer to a Value representing a linked list of arguments
+returns: the signed 8-bit integer at the given index; a void-type Value, after storing one there
+*/
+Value *primitiveBytevectorS8Ref(Value *args) {
+    return bytevectorRef(args, 1, true, "bytevector-s8-ref");
+}
+
+Value *primitiveBytevectorS8Set(Value *args) {
+    return bytevectorSet(args, 1, true, "bytevector-s8-set!");
+}
+
+/*
+primitiveBytevectorU16Ref, primitiveBytevectorU16Set
+params: args - a pointer to a Value representing a linked list of arguments
+returns: the unsigned 16-bit integer at the given index, in the optional byte order; a void-type Value, after storing one there
+*/
+Value *primitiveBytevectorU16Ref(Value *args) {
+    return bytevectorRef(args, 2, false, "bytevector-u16-ref");
+}
+
+Value *primitiveBytevectorU16Set(Value *args) {
+    return bytevectorSet(args, 2, false, "bytevector-u16-set!");
+}
+
+/*
+primitiveBytevectorS16Ref, primitiveBytevectorS16Set
+params: args - a pointer to a Value representing a linked list of arguments
+returns: the signed 16-bit integer at the given index, in the optional byte order; a void-type Value, after storing one there
+*/
+Value *primitiveBytevectorS16Ref(Value *args) {
+    return bytevectorRef(args, 2, true, "bytevector-s16-ref");
+}
+
+Value *primitiveBytevectorS16Set(Value *args) {
+    return bytevectorSet(args, 2, true, "bytevector-s16-set!");
+}
+
+/*
+primitiveBytevectorU32Ref, primitiveBytevectorU32Set
+params: args - a pointer to a Value representing a linked list of arguments
+returns: the unsigned 32-bit integer at the given index, in the optional byte order; a void-type Value, after storing one there
+*/
+Value *primitiveBytevectorU32Ref(Value *args) {
+    return bytevectorRef(args, 4, false, "bytevector-u32-ref");
+}
+
+Value *primitiveBytevectorU32Set(Value *args) {
+    return bytevectorSet(args, 4, false, "bytevector-u32-set!");
+}
+
+/*
+primitiveBytevectorS32Ref, primitiveBytevectorS32Set
+params: args - a pointer to a Value representing a linked list of arguments
+returns: the signed 32-bit integer at the given index, in the optional byte order; a void-type Value, after storing one there
+*/
+Value *primitiveBytevectorS32Ref(Value *args) {
+    return bytevectorRef(args, 4, true, "bytevector-s32-ref");
+}
+
+Value *primitiveBytevectorS32Set(Value *args) {
+    return bytevectorSet(args, 4, true, "bytevector-s32-set!");
+}
+
+/*
+primitiveBytevectorU64Ref, primitiveBytevectorU64Set
 params: args - a pointer to a Value representing a linked list of arguments
-returns: a pointer to a Value representing the first item in a given list
-primitiveCar() will throw an error if it is given greater or fewer than one argument.
+returns: the unsigned 64-bit integer at the given index, in the optional byte order; a void-type Value, after storing one there
 */
-Value *primitiveCar(Value *args) {
-    if (args -> type == NULL_TYPE || cdr(args) -> type != NULL_TYPE) {
-        printf("Evaluation error: incorrect number of args for 'car'\n");
-        texit(0);
-    } else {
-        Value *arg = car(args);
-        if (arg -> type != CONS_TYPE) {
-            printf("Evaluation error: argument to car is not a cons cell\n");
-            texit(0);
-        } else {
-            return car(arg);
-        }
-    }
-    return makeNull();
+Value *primitiveBytevectorU64Ref(Value *args) {
+    return bytevectorRef(args, 8, false, "bytevector-u64-ref");
+}
+
+Value *primitiveBytevectorU64Set(Value *args) {
+    return bytevectorSet(args, 8, false, "bytevector-u64-set!");
 }
 
 /*
-primitiveCdr
-params: a pointer to a Value representing a linked list of arguments
-returns: a pointer to a Value representing everything but the first item in a given list
-primitiveCdr() will throw an error if it is given greater or fewer than one argument.
+primitiveBytevectorS64Ref, primitiveBytevectorS64Set
+params: args - a pointer to a Value representing a linked list of arguments
+returns: the signed 64-bit integer at the given index, in the optional byte order; a void-type Value, after storing one there
 */
-Value *primitiveCdr(Value *args) {
-    if (args -> type == NULL_TYPE || cdr(args) -> type != NULL_TYPE) {
-        printf("Evaluation error: incorrect number of args for 'cdr'\n");
-        texit(0);
-    } else {
-        Value *arg = car(args);
-        if (arg -> type != CONS_TYPE) {
-            printf("Evaluation error: argument to cdr is not a cons cell\n");
-            texit(0);
-        } else {
-            return cdr(arg);
-        }
-    }
-    return makeNull();
+Value *primitiveBytevectorS64Ref(Value *args) {
+    return bytevectorRef(args, 8, true, "bytevector-s64-ref");
+}
+
+Value *primitiveBytevectorS64Set(Value *args) {
+    return bytevectorSet(args, 8, true, "bytevector-s64-set!");
 }
 
 /*
-primitiveCons
-params: args - a pointer to a Value struct
-returns: a pointer to a Value struct
-Returns a Cons cell of the two values contained within args. If args does not contain exactly two args, throw an error.
+setSlot
+params: frame - a pointer to a Frame struct, slot - the index of one of its slots, value - a pointer to a Value
+returns: nothing
+setSlot() binds the variable in the frame's slot to value, telling the garbage collector about the write.
 */
-Value *primitiveCons(Value *args) {
-    // If args does not contain exactly two args, throw an error.
-    if (args -> type == NULL_TYPE || cdr(args) -> type == NULL_TYPE || cdr(cdr(args)) -> type != NULL_TYPE) {
-        printf("Evaluation error: incorrect number of args for 'cons'\n");
-        texit(0);
-
-    } else {
-        return cons(car(args), car(cdr(args)));
-    }
-    return makeNull();
+void setSlot(Frame *frame, uint32_t slot, Value *value) {
+    frame -> slots[slot] = REF(value);
+    gcRecordWrite(frame, true, value);
 }
 
 /*
 bind
-params: name - a pointer to a string, function - a pointer to a function, frame - a pointer to a Frame struct
+params: name - a pointer to a string, function - a pointer to a function
 returns: nothing
-bind() adds a definition to the global frame where the given name is the key and the function pointer is its value.
+bind() adds a definition to the global environment where the given name is the key and the function pointer is its value.
 */
-void bind(char *name, Value *(*function)(struct Value *), Frame *frame) {
+void bind(char *name, Value *(*function)(struct Value *)) {
     Value *functionValue = talloc(sizeof(Value));
     functionValue -> type = PRIMITIVE_TYPE;
     functionValue -> pf = function;
-    
-    Value *nameValue = talloc(sizeof(Value));
-    nameValue -> type = SYMBOL_TYPE;
-    nameValue -> s = name;
 
-    Value *binding = cons(nameValue, functionValue);
-    
-    frame -> bindings = cons(binding, frame -> bindings);
+    globalCell(intern(name)) -> value = functionValue;
 }
 
 /*
@@ -450,24 +1644,28 @@ returns: a Value struct containing the evaluated arguments to be passed into app
 */
 Value *evalEach(Value *args, Frame *frame, bool needsReversal) {
     Value *evaledArgs = makeNull();
+    gcPushFrame(&frame);
+    gcPushValue(&evaledArgs);
     Value *arg = args;
-    while (arg -> type != NULL_TYPE) {
-        evaledArgs = cons(eval(car(arg), frame), evaledArgs);
+    while (typeOf(arg) != NULL_TYPE) {
+        Value *evaledArg = eval(car(arg), frame);
+        evaledArgs = cons(evaledArg, evaledArgs);
         arg = cdr(arg);
     }
-    if (needsReversal && evaledArgs -> type != NULL_TYPE) {
+    gcPop(2);
+    if (needsReversal && typeOf(evaledArgs) != NULL_TYPE) {
 
         //reverse the list of parse trees
         Value *prev = makeNull();
         Value *current = evaledArgs;
         Value *next = cdr(evaledArgs);
-        while (next->type != NULL_TYPE) {
-            current->c.cdr = prev;
+        while (typeOf(next) != NULL_TYPE) {
+            setCdr(current, prev);
             prev = current;
             current = next;
             next = cdr(next);
         }
-        current->c.cdr = prev;
+        setCdr(current, prev);
         evaledArgs = current;
     }
     return evaledArgs;
@@ -481,128 +1679,218 @@ returns: a new Value of type CLOSURE_TYPE containing the information provided in
 Value *makeClosure(Frame *environment, Value *parameters, Value *functionBody) {
     Value *closure = talloc(sizeof(Value));
     closure -> type = CLOSURE_TYPE;
-    closure -> cl.paramNames = parameters;
-    closure -> cl.functionCode = functionBody;
-    closure -> cl.frame = environment;
+    closure -> cl.paramNames = REF(parameters);
+    closure -> cl.functionCode = REF(functionBody);
+    closure -> cl.frame = REF(environment);
     return closure;
 }
 
 /*
 makeFrame
-params: parent - a pointer to a Frame struct
+params: scope - a pointer to a SCOPE_TYPE Value, or NULL for the global frame; parent - a pointer to a Frame struct
 returns: newFrame - a pointer to a Frame struct
-Given a parent frame, allocates a null Frame and sets its parent to point to the parameter.
+Allocates a Frame with one slot for each of scope's variables, all of them unbound, and sets its parent to point to the parameter.
+*/
+Frame *makeFrame(Value *scope, Frame *parent) {
+    uint32_t size = scope == NULL ? 0 : scope -> sc.size;
+    Frame *newFrame = tallocFrame(FRAME_BYTES(size));
+    newFrame -> parent = REF(parent);
+    newFrame -> scope = REF(scope);
+    for (uint32_t slot = 0; slot < size; slot++) {
+        newFrame -> slots[slot] = REF(NULL);
+    }
+    return newFrame;
+}
+
+/*
+slotNamed
+params: frame - a pointer to a Frame struct other than the global frame, name - an interned symbol name
+returns: the index of the slot the frame's scope gives the variable with that name, or the number of slots if there is none
 */
-Frame *makeFrame(Frame *parent) {
-   Frame *newFrame = talloc(sizeof(Frame));
-   newFrame -> parent = parent;
-   newFrame -> bindings = makeNull();
-   return newFrame;
+uint32_t slotNamed(Frame *frame, char *name) {
+    uint32_t slot = 0;
+    Value *names = VALUE_AT(VALUE_AT(frame -> scope) -> sc.names);
+    while (typeOf(names) != NULL_TYPE && car(names) -> s != name) {
+        names = cdr(names);
+        slot++;
+    }
+    return slot;
 }
 
 /*
 addBinding
 params: binding - a pointer to a Value representing a binding in dotted pair format; frame - a pointer to a Frame
 returns: nothing
-addBinding() adds the given binding to the given frame's list of bindings.
+addBinding() binds a variable defined in the given frame. A variable a resolved body defines already has a slot, which is
+unbound until its define runs. A binding in the global frame goes in its variable's cell in the global environment instead,
+replacing whatever was there, so that the variable can be redefined.
 */
 void addBinding(Value *binding, Frame *frame) {
-    Value *current = frame -> bindings;
+    // check to make sure variable to be bound is of symbol type
+    if (typeOf(car(binding)) != SYMBOL_TYPE) {
+        printf("Evaluation error: variable being bound must be of symbol type\n");
+        texit(0);
+    } else if (frame == globalFrame) {
+        globalCell(car(binding) -> s) -> value = cdr(binding);
+        return;
+    }
+
+    uint32_t slot = slotNamed(frame, car(binding) -> s);
     // check for multiple bindings for a variable (not allowed)
-    while (current -> type != NULL_TYPE) {
-        if (!strcmp(car(car(current)) -> s, car(binding) -> s)) {
-            printf("Evaluation error: local variable %s already bound\n", car(binding) -> s);
-            texit(0);
-        }
-        current = cdr(current);
+    if (slot < FRAME_SLOTS(frame) && VALUE_AT(frame -> slots[slot]) != NULL) {
+        printf("Evaluation error: local variable %s already bound\n", car(binding) -> s);
+        texit(0);
+    } else if (slot == FRAME_SLOTS(frame)) {
+        printf("Evaluation error: %s can't be defined here\n", car(binding) -> s);
+        texit(0);
     }
+    setSlot(frame, slot, cdr(binding));
+}
 
-    // check to make sure variable to be bound is of symbol type
-    if (car(binding) -> type != SYMBOL_TYPE) {
-        printf("Evaluation error: variable being bound must be of symbol type\n");
+/*
+applyRecordProcedure
+params: procedure - a pointer to the RecordProcedure of a constructor, predicate, accessor or modifier; args - a pointer to a value representing a list of previously evaluated arguments
+returns: a new record for a constructor, a boolean for a predicate, the field's value for an accessor and VOID_VALUE for a modifier
+Each field's index was worked out by define-record-type, so getting or setting a field is a check of the record's type and a single load or store.
+*/
+Value *applyRecordProcedure(struct RecordProcedure *procedure, Value *args) {
+    RecordType *type = procedure -> type;
+    uint32_t expected = procedure -> kind == RECORD_CONSTRUCTOR ? procedure -> argCount
+                      : procedure -> kind == RECORD_MODIFIER ? 2 : 1;
+    // if the wrong number of arguments is passed, throw an error.
+    if ((uint32_t)length(args) != expected) {
+        printf("Evaluation error: wrong number of args passed to a procedure of record type %s\n", type -> name);
         texit(0);
+    }
 
-    } else {
-        frame -> bindings = cons(binding, frame -> bindings);
+    if (procedure -> kind == RECORD_CONSTRUCTOR) {
+        Value *record = makeRecord(type);
+        for (uint32_t i = 0; i < procedure -> argCount; i++) {
+            recordSet(record, procedure -> argFields[i], car(args));
+            args = cdr(args);
+        }
+        return record;
+    }
+
+    Value *record = car(args);
+    bool isInstance = typeOf(record) == RECORD_TYPE && record -> rec -> type == type;
+    if (procedure -> kind == RECORD_PREDICATE) {
+        return isInstance ? TRUE_VALUE : FALSE_VALUE;
+    }
+
+    // if an accessor or modifier is given something other than a record of its type, throw an error.
+    if (!isInstance) {
+        printf("Evaluation error: argument to the accessor or modifier of field %s is not a %s record\n", type -> fieldNames[procedure -> field], type -> name);
+        texit(0);
     }
+    if (procedure -> kind == RECORD_ACCESSOR) {
+        return recordRef(record, procedure -> field);
+    }
+    recordSet(record, procedure -> field, car(cdr(args)));
+    return VOID_VALUE;
 }
 
 /*
 apply
 params: evaledOperator - a pointer to a Value struct that represents a closure corresponding to a function; evaledArgs - a pointer to a value representing a list of previously evaluated function arguments
 returns: the result of evaluating the body contained in the given closure, in the context of evaledArgs and the closure's environment
-apply() builds a new frame whose parent is the environment specified in the given closure, and adds bindings to it corresponding to each parameter/argument pair.
+apply() builds a new frame whose parent is the environment specified in the given closure, and puts each argument in the slot of its parameter.
 apply() then evaluates the function body specified in the given closure in the context of the new frame, and returns the result.
 */
 Value *apply(Value *evaledOperator, Value *evaledArgs) {
     // if the given operator is not a function, throw an error.
-    if (evaledOperator -> type != CLOSURE_TYPE && evaledOperator -> type != PRIMITIVE_TYPE) {
+    if (typeOf(evaledOperator) != CLOSURE_TYPE && typeOf(evaledOperator) != PRIMITIVE_TYPE
+        && typeOf(evaledOperator) != RECORD_PROCEDURE_TYPE) {
         printf("Evaluation error: non-function being called as function\n");
         texit(0);
     
     //
-    } else if (evaledOperator -> type == PRIMITIVE_TYPE) {
+    } else if (typeOf(evaledOperator) == PRIMITIVE_TYPE) {
         Value *result = (evaledOperator -> pf)(evaledArgs);
         return result;
+
+    //
+    } else if (typeOf(evaledOperator) == RECORD_PROCEDURE_TYPE) {
+        return applyRecordProcedure(evaledOperator -> rp, evaledArgs);
         
     // 
+    // every closure comes from a resolved lambda, which has a scope in place of its parameters
     } else {
-        Frame *frame = makeFrame(evaledOperator -> cl.frame);
-        Value *param = evaledOperator -> cl.paramNames;
-        Value *arg = evaledArgs;
-        while (param -> type != NULL_TYPE) {
-            // if too few arguments are passed, throw an error.
-            if (arg -> type == NULL_TYPE) {
-                printf("Evaluation error: too few args passed to function\n");
+        Value *scope = VALUE_AT(evaledOperator -> cl.paramNames);
+        Frame *frame = makeFrame(scope, FRAME_AT(evaledOperator -> cl.frame));
+        uint32_t count = 0;
+        for (Value *arg = evaledArgs; typeOf(arg) != NULL_TYPE; arg = cdr(arg)) {
+            // if too many arguments are passed, throw an error.
+            if (count == scope -> sc.initialized) {
+                printf("Evaluation error: too many args passed to function\n");
                 texit(0);
             }
-            Value *binding = cons(car(param), car(arg));
-            addBinding(binding, frame);
-            arg = cdr(arg);
-            param = cdr(param);
+            frame -> slots[count++] = REF(car(arg));
         }
-
-        // if too many arguments are passed, throw an error.
-        if (arg -> type != NULL_TYPE) {
-            printf("Evaluation error: too many args passed to function\n");
+        // if too few arguments are passed, throw an error.
+        if (count < scope -> sc.initialized) {
+            printf("Evaluation error: too few args passed to function\n");
             texit(0);
         }
 
+        // the body is run here rather than by evalBegin, so a call uses no more of the C stack than it has to
         Value *result;
-        Value *body = evaledOperator -> cl.functionCode;
-        while (body -> type != NULL_TYPE) {
+        Value *body = VALUE_AT(evaledOperator -> cl.functionCode);
+        gcPushFrame(&frame);
+        while (typeOf(body) != NULL_TYPE) {
             result = eval(car(body), frame);
             body = cdr(body);
         }
-        // return the final evaluated expression in body
+        gcPop(1);
         return result;
     }
     return makeNull();
 }
 
 /*
-lookUpSymbol
-params: symbol - a pointer to a Value struct, frame - a pointer to a Frame struct
-returns: a pointer to a Value struct
-Given a frame and a symbol, traverse the frame searching for the symbol's assigned value.
+lookUpLocal
+params: reference - a pointer to a LOCAL_REF_TYPE Value, frame - a pointer to a Frame struct
+returns: a pointer to the frame the reference's variable is in; its slot is reference -> lr.slot
+Goes out the reference's depth frames from frame, without comparing any names.
 */
-Value *lookUpSymbol(Value *symbol, Frame *frame) {
-    Value *currentBinding = frame -> bindings;
-    while (currentBinding -> type != NULL_TYPE) {
-        if (!strcmp(car(car(currentBinding)) -> s, symbol -> s)) {
-            return car(currentBinding);
-        } else {
-            currentBinding = cdr(currentBinding);
-        }
+Frame *lookUpLocal(Value *reference, Frame *frame) {
+    for (uint32_t i = 0; i < reference -> lr.depth; i++) {
+        frame = FRAME_AT(frame -> parent);
     }
+    return frame;
+}
 
+/*
+lookUpGlobal
+params: variable - a pointer to a SYMBOL_TYPE or GLOBAL_REF_TYPE Value
+returns: a pointer to the global environment's cell for the variable
+A GLOBAL_REF_TYPE value already points at its cell, so only a symbol has to be looked up. Throws an error if the variable isn't bound.
+*/
+GlobalCell *lookUpGlobal(Value *variable) {
+    GlobalCell *cell = typeOf(variable) == GLOBAL_REF_TYPE ? variable -> global : globalLookup(variable -> s);
     // if the symbol has not been defined, throw an error.
-    if (frame -> parent == NULL) {
-        printf("Evaluation error: binding for symbol '%s' not defined in a frame\n", symbol -> s);
+    if (cell == NULL || cell -> value == NULL) {
+        printf("Evaluation error: binding for symbol '%s' not defined in a frame\n", cell != NULL ? cell -> name : variable -> s);
         texit(0);
     }
+    return cell;
+}
 
-    return lookUpSymbol(symbol, frame -> parent);
+/*
+lookUpSymbol
+params: symbol - a pointer to a Value struct, frame - a pointer to a Frame struct; slot - where to put the variable's slot
+returns: a pointer to the frame the symbol's variable is in, or NULL if the symbol is a global variable
+Given a frame and a symbol, traverse the frames searching for a bound variable with the symbol's name. The global frame's
+variables are in the global environment, so the search stops there, and the caller looks the symbol up with lookUpGlobal.
+*/
+Frame *lookUpSymbol(Value *symbol, Frame *frame, uint32_t *slot) {
+    for (; frame != globalFrame; frame = FRAME_AT(frame -> parent)) {
+        *slot = slotNamed(frame, symbol -> s);
+        if (*slot < FRAME_SLOTS(frame) && VALUE_AT(frame -> slots[*slot]) != NULL) {
+            return frame;
+        }
+    }
+    return NULL;
 }
 
 /*
@@ -613,19 +1901,93 @@ Adds the bindings requested by args to the global frame.
 */
 Value *evalDefine(Value *args, Frame *frame) {
     // if no arguments or body are provided for define or too many arguments are provided, throw an error.
-    if (args -> type == NULL_TYPE || cdr(args) -> type == NULL_TYPE  || cdr(cdr(args)) -> type != NULL_TYPE) {
+    if (typeOf(args) == NULL_TYPE || typeOf(cdr(args)) == NULL_TYPE  || typeOf(cdr(cdr(args))) != NULL_TYPE) {
         printf("Evaluation error: incorrect number of args for define\n");
         texit(0);
     // if the given variable for definition is not a symbol, throw an error.
-    } else if (car(args) -> type != SYMBOL_TYPE) {
+    } else if (typeOf(car(args)) != SYMBOL_TYPE) {
         printf("Evaluation error: trying to define non-variable\n");
         texit(0);
     }
-    addBinding(cons(car(args), eval(car(cdr(args)), frame)), frame);
+    gcPushFrame(&frame);
+    Value *evaledExpression = eval(car(cdr(args)), frame);
+    gcPop(1);
+    addBinding(cons(car(args), evaledExpression), frame);
+
+    return VOID_VALUE;
+}
+
+/*
+evalDefineRecordType
+params: args - a pointer to a Value struct, frame - a pointer to a Frame struct
+returns: a Value struct of type VOID_TYPE
+Given args of the form (<name> (constructor field ...) predicate (field accessor [modifier]) ...), defines a new record type in
+frame, along with its constructor, predicate, and each field's accessor and modifier. Every field gets its index in the record
+here, once, and the procedures carry it, so none of them ever has to look a field up by name.
+*/
+Value *evalDefineRecordType(Value *args, Frame *frame) {
+    // if the type name, constructor or predicate is missing, throw an error.
+    if (length(args) < 3) {
+        printf("Evaluation error: incorrect number of args for define-record-type\n");
+        texit(0);
+    }
+    Value *typeName = car(args);
+    Value *constructor = car(cdr(args));
+    Value *predicate = car(cdr(cdr(args)));
+    Value *fields = cdr(cdr(cdr(args)));
+    if (typeOf(typeName) != SYMBOL_TYPE || typeOf(predicate) != SYMBOL_TYPE) {
+        printf("Evaluation error: record type and predicate names must be symbols\n");
+        texit(0);
+    }
+
+    // every field is a list of its name, its accessor and, optionally, its modifier.
+    RecordType *type = makeRecordType(typeName -> s, length(fields));
+    uint32_t index = 0;
+    for (Value *current = fields; typeOf(current) != NULL_TYPE; current = cdr(current)) {
+        Value *field = car(current);
+        int size = length(field);
+        if (typeOf(field) != CONS_TYPE || size < 2 || size > 3 || typeOf(car(field)) != SYMBOL_TYPE) {
+            printf("Evaluation error: bad field in define-record-type\n");
+            texit(0);
+        } else if (recordFieldIndex(type, car(field) -> s) < index) {
+            printf("Evaluation error: duplicate field %s in define-record-type\n", car(field) -> s);
+            texit(0);
+        }
+        type -> fieldNames[index++] = car(field) -> s;
+    }
+
+    addBinding(cons(typeName, makeRecordDescriptor(type)), frame);
+
+    // the constructor is a list of its name and the fields it takes, in order, or #f for none.
+    if (typeOf(constructor) == CONS_TYPE && typeOf(car(constructor)) == SYMBOL_TYPE) {
+        Value *procedure = makeRecordProcedure(RECORD_CONSTRUCTOR, type, 0, length(cdr(constructor)));
+        uint32_t i = 0;
+        for (Value *current = cdr(constructor); typeOf(current) != NULL_TYPE; current = cdr(current)) {
+            uint32_t field = typeOf(car(current)) == SYMBOL_TYPE ? recordFieldIndex(type, car(current) -> s) : type -> fieldCount;
+            if (field == type -> fieldCount) {
+                printf("Evaluation error: constructor argument is not a field of record type %s\n", type -> name);
+                texit(0);
+            }
+            procedure -> rp -> argFields[i++] = field;
+        }
+        addBinding(cons(car(constructor), procedure), frame);
+    } else if (constructor != FALSE_VALUE) {
+        printf("Evaluation error: bad constructor in define-record-type\n");
+        texit(0);
+    }
 
-    Value *returnValue = talloc(sizeof(Value));
-    returnValue -> type = VOID_TYPE;
-    return returnValue;
+    addBinding(cons(predicate, makeRecordProcedure(RECORD_PREDICATE, type, 0, 0)), frame);
+
+    index = 0;
+    for (Value *current = fields; typeOf(current) != NULL_TYPE; current = cdr(current)) {
+        Value *field = cdr(car(current));
+        addBinding(cons(car(field), makeRecordProcedure(RECORD_ACCESSOR, type, index, 0)), frame);
+        if (typeOf(cdr(field)) != NULL_TYPE) {
+            addBinding(cons(car(cdr(field)), makeRecordProcedure(RECORD_MODIFIER, type, index, 0)), frame);
+        }
+        index++;
+    }
+    return VOID_VALUE;
 }
 
 /*
@@ -637,39 +1999,39 @@ evalLambda() also performs general error checking, including the number of args,
 */
 Value *evalLambda(Value *args, Frame *frame) {
     // if too few arguments are given for lambda, throw an error.
-    if (args -> type == NULL_TYPE || cdr(args) -> type == NULL_TYPE) {
+    if (typeOf(args) == NULL_TYPE || typeOf(cdr(args)) == NULL_TYPE) {
         printf("Evaluation error: incorrect number of args for lambda\n");
         texit(0);
     }
-    
+
+    // the resolver gives every lambda whose parameters are a list of distinct symbols a scope, checking them once
+    if (typeOf(car(args)) == SCOPE_TYPE) {
+        return makeClosure(frame, car(args), cdr(args));
+    }
+
+    // so this lambda's parameters are bad; find out how
     Value *params = car(args);
-    Value *param = params;
-    Value *visited = makeNull();
-    while (param -> type != NULL_TYPE) {
+    for (Value *param = params; typeOf(param) != NULL_TYPE; param = cdr(param)) {
         // if lambda's parameters are not formatted correctly, throw an error.
-        if (param -> type != CONS_TYPE) {
+        if (typeOf(param) != CONS_TYPE) {
             printf("Evaluation error: bad param formatting in lambda\n");
             texit(0);
         // if lambda's paramters are not a symbol, throw an error.
-        } else if (car(param) -> type != SYMBOL_TYPE) {
+        } else if (typeOf(car(param)) != SYMBOL_TYPE) {
             printf("Evaluation error: non-variable param in lambda\n");
             texit(0);
-        } else {
-            Value *existing = visited;
-            while (existing -> type != NULL_TYPE) {
-                // if lambda's parameters contain duplicate identifiers, throw an error.
-                if (!strcmp(car(existing) -> s, car(param) -> s)) {
-                    printf("Evaluation error: duplicate identifier in lambda\n");
-                    texit(0);
-                }
-                existing = cdr(existing);
+        }
+        for (Value *earlier = params; earlier != param; earlier = cdr(earlier)) {
+            // if lambda's parameters contain duplicate identifiers, throw an error.
+            if (car(earlier) -> s == car(param) -> s) {
+                printf("Evaluation error: duplicate identifier in lambda\n");
+                texit(0);
             }
-            visited = cons(car(param), visited);
-            param = cdr(param);
         }
     }
-    
-    return makeClosure(frame, params, cdr(args));
+    printf("Evaluation error: bad param formatting in lambda\n");
+    texit(0);
+    return makeNull();
 }
 
 /*
@@ -680,18 +2042,20 @@ Function is called in the case that an 'if' symbol is evaluated. Returns the sec
 */
 Value *evalIf(Value *args, Frame *frame) {
     // if more or less than 3 args provided, throw an error.
-    if (cdr(args) -> type == NULL_TYPE || cdr(cdr(args)) -> type == NULL_TYPE || cdr(cdr(cdr(args))) -> type != NULL_TYPE) {
+    if (typeOf(cdr(args)) == NULL_TYPE || typeOf(cdr(cdr(args))) == NULL_TYPE || typeOf(cdr(cdr(cdr(args)))) != NULL_TYPE) {
         printf("Evaluation error: incorrect number of args for if statement\n");
         texit(0);
     }
 
+    gcPushFrame(&frame);
     Value *boolResult = eval(car(args), frame);
+    gcPop(1);
     // if the first arg does not evaluate to a boolean, throw an error.
-    if (boolResult -> type != BOOL_TYPE) {
+    if (typeOf(boolResult) != BOOL_TYPE) {
         printf("Evaluation error: if statement predicate does not resolve to boolean\n");
         texit(0);
 
-    } else if (boolResult -> i == 1) {
+    } else if (boolResult == TRUE_VALUE) {
         return eval(car(cdr(args)), frame);
 
     } else {
@@ -709,18 +2073,18 @@ evalBegin() evaluates each of its arguments and returns the result of its last a
 */
 Value *evalBegin(Value *args, Frame *frame) {
     // if there are no arguments, return a Value of VOID_TYPE
-    if (args -> type == NULL_TYPE) {
-        Value *returnValue = talloc(sizeof(Value));
-        returnValue -> type = VOID_TYPE;
-        return returnValue;
+    if (typeOf(args) == NULL_TYPE) {
+        return VOID_VALUE;
     }
     
     // else, return the evaluated final argument
     Value *result;
-    while (args -> type != NULL_TYPE) {
+    gcPushFrame(&frame);
+    while (typeOf(args) != NULL_TYPE) {
         result = eval(car(args), frame);
         args = cdr(args);
     }
+    gcPop(1);
     return result;
 }
 
@@ -733,22 +2097,72 @@ Throws an error if the variable has not yet been defined
 */
 Value *evalSetbang(Value *args, Frame *frame) {
     // if no arguments or body are provided for define or too many arguments are provided, throw an error.
-    if (args -> type == NULL_TYPE || cdr(args) -> type == NULL_TYPE  || cdr(cdr(args)) -> type != NULL_TYPE) {
+    if (typeOf(args) == NULL_TYPE || typeOf(cdr(args)) == NULL_TYPE  || typeOf(cdr(cdr(args))) != NULL_TYPE) {
         printf("Evaluation error: incorrect number of args for 'set!'\n");
         texit(0);
     // if the given variable for definition is not a symbol, throw an error.
-    } else if (car(args) -> type != SYMBOL_TYPE) {
+    } else if (typeOf(car(args)) != SYMBOL_TYPE && typeOf(car(args)) != LOCAL_REF_TYPE && typeOf(car(args)) != GLOBAL_REF_TYPE) {
         printf("Evaluation error: trying to reassign non-variable with 'set!'\n");
         texit(0);
     }
-    // find symbol, then reassign its value
-    Value *symbol = lookUpSymbol(car(args), frame);
-    symbol -> c.cdr = eval(car(cdr(args)), frame);
+    // evaluate the new value, then find symbol and reassign its value
+    gcPushFrame(&frame);
+    Value *newValue = eval(car(cdr(args)), frame);
+    gcPop(1);
+    Value *variable = car(args);
+    Frame *variableFrame = NULL;
+    uint32_t slot = 0;
+    if (typeOf(variable) == LOCAL_REF_TYPE) {
+        variableFrame = lookUpLocal(variable, frame);
+        slot = variable -> lr.slot;
+        // if the variable's define hasn't run yet, the name still means whatever it means outside its frame.
+        if (VALUE_AT(variableFrame -> slots[slot]) == NULL) {
+            variable = VALUE_AT(variable -> lr.symbol);
+            variableFrame = lookUpSymbol(variable, FRAME_AT(variableFrame -> parent), &slot);
+        }
+    } else if (typeOf(variable) == SYMBOL_TYPE) {
+        variableFrame = lookUpSymbol(variable, frame, &slot);
+    }
+    if (variableFrame == NULL) {
+        lookUpGlobal(variable) -> value = newValue;
+    } else {
+        setSlot(variableFrame, slot, newValue);
+    }
 
     // return Value of VOID_TYPE
-    Value *returnValue = talloc(sizeof(Value));
-    returnValue -> type = VOID_TYPE;
-    return returnValue;
+    return VOID_VALUE;
+}
+
+/*
+reportBadBindings
+params: bindings - a pointer to a Value representing the bindings of a let or letrec statement; form - "let" or "letrec"
+returns: nothing
+The resolver gives every let or letrec whose bindings are (name expression) lists with distinct names a scope, so one without
+a scope has bad bindings; reportBadBindings() throws the error that says how.
+*/
+void reportBadBindings(Value *bindings, char *form) {
+    for (Value *binding = bindings; typeOf(binding) != NULL_TYPE; binding = cdr(binding)) {
+        // check outer list format, then each binding itself
+        if (typeOf(binding) != CONS_TYPE || typeOf(car(binding)) != CONS_TYPE || typeOf(cdr(car(binding))) != CONS_TYPE) {
+            printf("Evaluation error: invalid %s binding\n", form);
+            texit(0);
+
+        // check to make sure variable to be bound is of symbol type
+        } else if (typeOf(car(car(binding))) != SYMBOL_TYPE) {
+            printf("Evaluation error: variable being bound must be of symbol type\n");
+            texit(0);
+        }
+
+        // check for multiple bindings for a variable (not allowed)
+        for (Value *earlier = bindings; earlier != binding; earlier = cdr(earlier)) {
+            if (car(car(earlier)) -> s == car(car(binding)) -> s) {
+                printf("Evaluation error: local variable %s already bound\n", car(car(binding)) -> s);
+                texit(0);
+            }
+        }
+    }
+    printf("Evaluation error: invalid %s binding\n", form);
+    texit(0);
 }
 
 /*
@@ -759,72 +2173,32 @@ evalLetrec() is functionally similar to evalLet(), but it allows recursive calls
 */
 Value *evalLetrec(Value *args, Frame *frame) {
     // if no arguments or body are provided for let, throw an error.
-    if (args -> type == NULL_TYPE || cdr(args) -> type == NULL_TYPE) {
+    if (typeOf(args) == NULL_TYPE || typeOf(cdr(args)) == NULL_TYPE) {
         printf("Evaluation error: incorrect number of args for letrec\n");
         texit(0);
 
+    } else if (typeOf(car(args)) != SCOPE_TYPE) {
+        reportBadBindings(car(args), "letrec");
     }
-    // create new frame in which to evaluate letrec
-    Frame *newFrame = makeFrame(frame);
-    
-    // checks list of bindings to make sure it is a proper list; throws error if not
-    if (car(args) -> type != CONS_TYPE && car(args) -> type != NULL_TYPE) {
-        printf("Evaluation error: invalid letrec binding\n");
-        texit(0);
-    }
-
-    Value *unspecValue = talloc(sizeof(Value));
-    unspecValue -> type = UNSPECIFIED_TYPE;
-    
-    // checks proper nested list formatting for list of bindings; throws error if bindings are incorrectly formatted
-    Value *binding = car(args);
-    while(binding -> type != NULL_TYPE) {
-        // check outer list format
-        if (binding -> type != CONS_TYPE) {
-            printf("Evaluation error: invalid letrec binding\n");
-            texit(0);
-
-        // check each binding itself
-        } else if (car(binding) -> type != CONS_TYPE) {
-            printf("Evaluation error: invalid letrec binding\n");
-            texit(0);
 
-        // create binding and temporarily set its value to UNSPECIFIED_TYPE
-        } else {
-            addBinding(cons(car(car(binding)), unspecValue), newFrame);
-            binding = cdr(binding);
-        }
+    // a resolved letrec is (letrec scope (expression ...) body ...); its variables are unspecified while the
+    // expressions are evaluated in its frame, then all bound at once
+    Frame *newFrame = makeFrame(car(args), frame);
+    for (uint32_t slot = 0; slot < car(args) -> sc.initialized; slot++) {
+        newFrame -> slots[slot] = REF(UNSPECIFIED_VALUE);
     }
-
-    // evaluate each expression in the context of newFrame and add the result to a temporary list
-    Value *tempList = makeNull();
-    binding = car(args);
-    while (binding -> type != NULL_TYPE) {
-        tempList = cons(eval(car(cdr(car(binding))), newFrame), tempList);
-        if (car(tempList) -> type == UNSPECIFIED_TYPE) {
+    gcPushFrame(&newFrame);
+    Value *values = evalEach(car(cdr(args)), newFrame, true);
+    gcPop(1);
+    for (uint32_t slot = 0; typeOf(values) != NULL_TYPE; slot++) {
+        if (typeOf(car(values)) == UNSPECIFIED_TYPE) {
             printf("Evaluation error: attempting to assign unspecified type\n");
             texit(0);
         }
-        binding = cdr(binding);
-    }
-
-    // Replace bindings with the evaluated expressions
-    binding = newFrame -> bindings;
-    while (binding -> type != NULL_TYPE) {
-        car(binding) -> c.cdr = car(tempList);
-        tempList = cdr(tempList);
-        binding = cdr(binding);
-    }
-
-    // evaluates body of the letrec statement in the context of newFrame 
-    Value *result;
-    Value *body = cdr(args);
-    while (body -> type != NULL_TYPE) {
-        result = eval(car(body), newFrame);
-        body = cdr(body);
+        setSlot(newFrame, slot, car(values));
+        values = cdr(values);
     }
-    // return the final evaluated expression in body
-    return result;
+    return evalBegin(cdr(cdr(args)), newFrame);
 }
 
 /*
@@ -835,59 +2209,52 @@ evalLet() creates a new Frame containing the let statement's bindings, then eval
 */
 Value *evalLet(Value *args, Frame *frame) {
     // if no arguments or body are provided for let, throw an error.
-    if (args -> type == NULL_TYPE || cdr(args) -> type == NULL_TYPE) {
+    if (typeOf(args) == NULL_TYPE || typeOf(cdr(args)) == NULL_TYPE) {
         printf("Evaluation error: incorrect number of args for let\n");
         texit(0);
 
+    } else if (typeOf(car(args)) != SCOPE_TYPE) {
+        reportBadBindings(car(args), "let");
     }
-    // create new frame in which to evaluate let
-    Frame *newFrame = makeFrame(frame);
-    
-    // checks list of bindings to make sure it is a proper list; throws error if not
-    if (car(args) -> type != CONS_TYPE && car(args) -> type != NULL_TYPE) {
-        printf("Evaluation error: invalid let binding\n");
-        texit(0);
-    }
-
-    // checks proper nested list formatting for list of bindings; throws error if bindings are incorrectly formatted
-    Value *binding = car(args);
-    while (binding -> type != NULL_TYPE) {
-        // check outer list format
-        if (binding -> type != CONS_TYPE) {
-            printf("Evaluation error: invalid let binding\n");
-            texit(0);
-
-        // check each binding itself
-        } else if (car(binding) -> type != CONS_TYPE) {
-            printf("Evaluation error: invalid let binding\n");
-            texit(0);
 
-        // adds binding to newFrame
-        } else {
-            addBinding(cons(car(car(binding)), eval(car(cdr(car(binding))), frame)), newFrame);
-            binding = cdr(binding);
-        }
+    // a resolved let is (let scope (expression ...) body ...); the expressions are evaluated in the outer frame, straight
+    // into the new frame's slots, so both have to be registered with the collector until the body runs in the new one
+    Frame *newFrame = makeFrame(car(args), frame);
+    gcPushFrame(&frame);
+    gcPushFrame(&newFrame);
+    uint32_t slot = 0;
+    for (Value *expression = car(cdr(args)); typeOf(expression) != NULL_TYPE; expression = cdr(expression)) {
+        Value *evaledExpression = eval(car(expression), frame);
+        setSlot(newFrame, slot++, evaledExpression);
     }
+    gcPop(2);
+    return evalBegin(cdr(cdr(args)), newFrame);
+}
 
-    // evaluates body of the let statement in the context of newFrame 
-    Value *result;
-    Value *body = cdr(args);
-    while (body -> type != NULL_TYPE) {
-        result = eval(car(body), newFrame);
-        body = cdr(body);
+/*
+evalQuote
+params: args - a pointer to a Value representing quote's args; frame - a pointer to a Frame, unused, which every
+        special form takes (see SpecialFormFunction)
+returns: the quoted datum, unevaluated
+*/
+Value *evalQuote(Value *args, Frame *frame) {
+    (void)frame;
+    // if there are none or multiple args given to quote, throw an error.
+    if (typeOf(args) != CONS_TYPE || typeOf(cdr(args)) != NULL_TYPE) {
+        printf("Evaluation error: incorrect number of args for quote\n");
+        texit(0);
     }
-    // return the final evaluated expression in body
-    return result;
+    return car(args);
 }
 
 /*
-eval
+evalExpression
 params: tree - a pointer to a Value struct, frame - a pointer to a Frame struct
 returns: a pointer to a Value struct
 Given a pointer to a parse tree and a pointer to a frame, evaluate the parse tree in the context of the current frame.
 */
-Value *eval(Value *tree, Frame *frame) {
-    switch (tree->type)  {
+Value *evalExpression(Value *tree, Frame *frame) {
+    switch (typeOf(tree))  {
         case UNSPECIFIED_TYPE: {
             printf("Evaluation error: attempting to assign unspecified type\n");
             texit(0);
@@ -895,64 +2262,76 @@ Value *eval(Value *tree, Frame *frame) {
         case INT_TYPE: {
             return tree;
         }
+        case BIGNUM_TYPE: {
+            return tree;
+        }
         case DOUBLE_TYPE: {
             return tree;
         }
         case STR_TYPE: {
             return tree;
         }
+        case VECTOR_TYPE: {
+            return tree;
+        }
+        case HASH_TYPE: {
+            return tree;
+        }
+        case F64VECTOR_TYPE: {
+            return tree;
+        }
+        case S64VECTOR_TYPE: {
+            return tree;
+        }
+        case BYTEVECTOR_TYPE: {
+            return tree;
+        }
+        case RECORD_TYPE: {
+            return tree;
+        }
         case BOOL_TYPE: {
             return tree;
         }
         case SYMBOL_TYPE: {
-            return cdr(lookUpSymbol(tree, frame));
-        }  
+            uint32_t slot;
+            Frame *variableFrame = lookUpSymbol(tree, frame, &slot);
+            return variableFrame != NULL ? VALUE_AT(variableFrame -> slots[slot]) : lookUpGlobal(tree) -> value;
+        }
+        case LOCAL_REF_TYPE: {
+            Frame *variableFrame = lookUpLocal(tree, frame);
+            Value *value = VALUE_AT(variableFrame -> slots[tree -> lr.slot]);
+            // if the variable's define hasn't run yet, the name still means whatever it means outside its frame.
+            if (value == NULL) {
+                uint32_t slot;
+                Value *symbol = VALUE_AT(tree -> lr.symbol);
+                Frame *outerFrame = lookUpSymbol(symbol, FRAME_AT(variableFrame -> parent), &slot);
+                return outerFrame != NULL ? VALUE_AT(outerFrame -> slots[slot]) : lookUpGlobal(symbol) -> value;
+            }
+            return value;
+        }
+        case GLOBAL_REF_TYPE: {
+            return lookUpGlobal(tree) -> value;
+        }
         case CONS_TYPE: {
             Value *first = car(tree);
             Value *args = cdr(tree);
 
-            if (first -> type != SYMBOL_TYPE && first -> type != CONS_TYPE) {
+            // the resolver tags the keyword of every special form, so that's the only check a call pays for
+            if (typeOf(first) == SPECIAL_FORM_TYPE) {
+                return first -> sf -> evaluate(args, frame);
+
+            } else if (typeOf(first) != SYMBOL_TYPE && typeOf(first) != CONS_TYPE
+                && typeOf(first) != LOCAL_REF_TYPE && typeOf(first) != GLOBAL_REF_TYPE) {
                 printf("Evaluation error: given type not a function\n");
                 texit(0);
 
-            } else if (!strcmp(first -> s, "if")) {
-               return evalIf(args, frame);
-               
-            } else if (!strcmp(first -> s, "let")) {
-                return evalLet(args, frame);
-
-            } else if (!strcmp(first -> s, "letrec")) {
-                return evalLetrec(args, frame);
-
-            } else if (!strcmp(first -> s, "quote")) {
-                // if there are none or multiple args given to quote, throw an error.
-                if (args -> type != CONS_TYPE || cdr(args) -> type != NULL_TYPE) {
-                    printf("Evaluation error: incorrect number of args for quote\n");
-                    texit(0);
-                } else {
-                    return car(args);
-                }
-            
-            } else if (!strcmp(first->s, "define")) { 
-                return evalDefine(args, frame);  
-
-            } else if (!strcmp(first->s, "lambda")) {
-                return evalLambda(args, frame);
-
-            } else if (!strcmp(first->s, "set!")) {
-                return evalSetbang(args, frame); 
-
-            } else if (!strcmp(first->s, "begin")) {
-                return evalBegin(args, frame);
-
             } else {
                 // if not special form, evaluate first and args, then try to apply the results as a function
+                gcPushFrame(&frame);
                 Value *evaledOperator = eval(first, frame);
-                bool needsReversal = true;
-                if (!strcmp(first->s, "car") || !strcmp(first->s, "cdr")) {
-                    needsReversal = false;
-                }
-                Value *evaledArgs = evalEach(args, frame, needsReversal);
+                gcPushValue(&evaledOperator);
+                Value *evaledArgs = evalEach(args, frame, true);
+                gcPop(2);
 
                 return apply(evaledOperator, evaledArgs);
             }
@@ -965,6 +2344,21 @@ Value *eval(Value *tree, Frame *frame) {
     return makeNull();    
 }
 
+/*
+eval
+params: tree - a pointer to a Value struct, frame - a pointer to a Frame struct
+returns: a pointer to a Value struct
+Given a pointer to a parse tree and a pointer to a frame, evaluate the parse tree in the context of the current frame.
+Every call to eval is a safe point for the garbage collector, which may move frame; evalExpression() and the
+functions it calls register frame themselves wherever they still need it after a nested call to eval.
+*/
+Value *eval(Value *tree, Frame *frame) {
+    gcPushFrame(&frame);
+    gcSafePoint();
+    gcPop(1);
+    return evalExpression(tree, frame);
+}
+
 /*
 printingHelper
 params: tree - a pointer to a Value struct, needsClose - a pointer to an integer
@@ -974,9 +2368,15 @@ Given a tree representing the result of evaluating a parse tree, print the conte
 void printingHelper(Value *tree) {
     Value *current;
     Value *currentCar;
-    switch (tree->type) {
+    switch (typeOf(tree)) {
         case INT_TYPE: {
-            printf("%i ", tree -> i);
+            printf("%lld ", (long long)intOf(tree));
+            break;
+        }
+        case BIGNUM_TYPE: {
+            char *text = integerToString(tree);
+            printf("%s ", text);
+            free(text);
             break;
         }
         case DOUBLE_TYPE: {
@@ -984,11 +2384,11 @@ void printingHelper(Value *tree) {
             break;
         }
         case STR_TYPE: {
-            printf("%s ", tree -> s);
+            printf("\"%s\" ", stringChars(tree));
             break;
         }
         case BOOL_TYPE: {
-            if (tree -> i == 1) {
+            if (tree == TRUE_VALUE) {
                 printf("#t");
             } else {
                 printf("#f");
@@ -1002,9 +2402,9 @@ void printingHelper(Value *tree) {
         case CONS_TYPE: {
             Value *current = tree;
             printf("(");
-            while (current -> type != NULL_TYPE) {
+            while (typeOf(current) != NULL_TYPE) {
                 currentCar = car(current);
-                if (cdr(current) -> type != CONS_TYPE && cdr(current) -> type != NULL_TYPE) {
+                if (typeOf(cdr(current)) != CONS_TYPE && typeOf(cdr(current)) != NULL_TYPE) {
                     printingHelper(currentCar);
                     printf(". ");
                     printingHelper(cdr(current));
@@ -1021,6 +2421,14 @@ void printingHelper(Value *tree) {
             printf("()");
             break;
         }
+        case VECTOR_TYPE: {
+            printf("#(");
+            for (uint32_t i = 0; i < tree -> vec -> length; i++) {
+                printingHelper(vectorRef(tree, i));
+            }
+            printf(") ");
+            break;
+        }
         case CLOSURE_TYPE: {
             printf("#<procedure>");
             break;
@@ -1029,6 +2437,54 @@ void printingHelper(Value *tree) {
             printf("#<procedure>");
             break;
         }
+        case HASH_TYPE: {
+            printf("#<hash-table>");
+            break;
+        }
+        case RECORD_TYPE: {
+            // a type is usually named like <point>, which already has the brackets
+            char *name = tree -> rec -> type -> name;
+            printf(name[0] == '<' ? "#%s" : "#<%s>", name);
+            break;
+        }
+        case RECORD_DESCRIPTOR_TYPE: {
+            char *name = tree -> rt -> name;
+            size_t nameLength = strlen(name);
+            if (name[0] == '<' && nameLength > 2 && name[nameLength - 1] == '>') {
+                printf("#<record-type %.*s>", (int)(nameLength - 2), name + 1);
+            } else {
+                printf("#<record-type %s>", name);
+            }
+            break;
+        }
+        case RECORD_PROCEDURE_TYPE: {
+            printf("#<procedure>");
+            break;
+        }
+        case F64VECTOR_TYPE: {
+            printf("#f64(");
+            for (uint32_t i = 0; i < tree -> f64v -> length; i++) {
+                printf("%lf ", tree -> f64v -> items[i]);
+            }
+            printf(") ");
+            break;
+        }
+        case S64VECTOR_TYPE: {
+            printf("#s64(");
+            for (uint32_t i = 0; i < tree -> s64v -> length; i++) {
+                printf("%lld ", (long long)tree -> s64v -> items[i]);
+            }
+            printf(") ");
+            break;
+        }
+        case BYTEVECTOR_TYPE: {
+            printf("#u8(");
+            for (uint64_t i = 0; i < tree -> bv -> length; i++) {
+                printf("%u ", tree -> bv -> bytes[i]);
+            }
+            printf(") ");
+            break;
+        }
         default:
             break;
     }
@@ -1042,28 +2498,118 @@ Given the pointer to a Scheme program, iteratively call eval() on each parse tre
 */
 void interpret(Value *tree) {
     Value *current = tree;
-    Frame *global = makeFrame(NULL);
+    globalFrame = makeFrame(NULL, NULL);
+
+    // the program and everything reachable from the global frame are the collector's roots
+    gcInit();
+    gcPushValue(&tree);
+    gcPushFrame(&globalFrame);
     
+    // add the special forms, which the resolver tags so evalExpression can call them straight away
+    defineSpecialForm("if", evalIf);
+    defineSpecialForm("let", evalLet);
+    defineSpecialForm("letrec", evalLetrec);
+    defineSpecialForm("quote", evalQuote);
+    defineSpecialForm("define", evalDefine);
+    defineSpecialForm("lambda", evalLambda);
+    defineSpecialForm("set!", evalSetbang);
+    defineSpecialForm("begin", evalBegin);
+    defineSpecialForm("define-record-type", evalDefineRecordType);
+
     //add primitive functions to the global frame
-    bind("+", primitivePlus, global);
-    bind("-", primitiveMinus, global);
-    bind("=", primitiveEqual, global);
-    bind("null?", primitiveNull, global);
-    bind("car", primitiveCar, global);
-    bind("cdr", primitiveCdr, global);
-    bind("cons", primitiveCons, global);
-    bind(">", primitiveGreatorThan, global);
-    bind("<", primitiveLessThan, global);
-
-    while (current->type != NULL_TYPE) {
-        Value *result = eval(car(current), global);
+    bind("+", primitivePlus);
+    bind("*", primitiveMultiply);
+    bind("-", primitiveMinus);
+    bind("=", primitiveEqual);
+    bind("null?", primitiveNull);
+    bind("car", primitiveCar);
+    bind("cdr", primitiveCdr);
+    bind("cons", primitiveCons);
+    bind(">", primitiveGreatorThan);
+    bind("<", primitiveLessThan);
+    bind("make-vector", primitiveMakeVector);
+    bind("vector", primitiveVector);
+    bind("vector-ref", primitiveVectorRef);
+    bind("vector-set!", primitiveVectorSet);
+    bind("vector-length", primitiveVectorLength);
+    bind("vector-fill!", primitiveVectorFill);
+    bind("vector->list", primitiveVectorToList);
+    bind("list->vector", primitiveListToVector);
+    bind("equal?", primitiveEqualp);
+    bind("make-hash-table", primitiveMakeHashTable);
+    bind("hash-table?", primitiveHashTablep);
+    bind("hash-table-set!", primitiveHashTableSet);
+    bind("hash-table-ref", primitiveHashTableRef);
+    bind("hash-table-ref/default", primitiveHashTableRefDefault);
+    bind("hash-table-contains?", primitiveHashTableContains);
+    bind("hash-table-delete!", primitiveHashTableDelete);
+    bind("hash-table-count", primitiveHashTableCount);
+    bind("hash-table->alist", primitiveHashTableToAlist);
+    bind("hash-table-keys", primitiveHashTableKeys);
+    bind("hash-table-values", primitiveHashTableValues);
+    bind("hash-table-walk", primitiveHashTableWalk);
+    bind("make-f64vector", primitiveMakeF64Vector);
+    bind("make-s64vector", primitiveMakeS64Vector);
+    bind("f64vector", primitiveF64Vector);
+    bind("s64vector", primitiveS64Vector);
+    bind("f64vector-length", primitiveF64VectorLength);
+    bind("s64vector-length", primitiveS64VectorLength);
+    bind("f64vector-ref", primitiveF64VectorRef);
+    bind("s64vector-ref", primitiveS64VectorRef);
+    bind("f64vector-set!", primitiveF64VectorSet);
+    bind("s64vector-set!", primitiveS64VectorSet);
+    bind("f64vector->list", primitiveF64VectorToList);
+    bind("s64vector->list", primitiveS64VectorToList);
+    bind("f64vector-add", primitiveF64VectorAdd);
+    bind("s64vector-add", primitiveS64VectorAdd);
+    bind("f64vector-mul", primitiveF64VectorMultiply);
+    bind("s64vector-mul", primitiveS64VectorMultiply);
+    bind("f64vector-scale", primitiveF64VectorScale);
+    bind("s64vector-scale", primitiveS64VectorScale);
+    bind("f64vector-sum", primitiveF64VectorSum);
+    bind("s64vector-sum", primitiveS64VectorSum);
+    bind("f64vector-dot", primitiveF64VectorDot);
+    bind("s64vector-dot", primitiveS64VectorDot);
+    bind("f64vector-min", primitiveF64VectorMin);
+    bind("s64vector-min", primitiveS64VectorMin);
+    bind("f64vector-max", primitiveF64VectorMax);
+    bind("s64vector-max", primitiveS64VectorMax);
+    bind("f64vector?", primitiveF64Vectorp);
+    bind("s64vector?", primitiveS64Vectorp);
+    bind("list->f64vector", primitiveListToF64Vector);
+    bind("list->s64vector", primitiveListToS64Vector);
+    bind("make-bytevector", primitiveMakeBytevector);
+    bind("bytevector", primitiveBytevector);
+    bind("bytevector?", primitiveBytevectorp);
+    bind("bytevector-length", primitiveBytevectorLength);
+    bind("file->bytevector", primitiveFileToBytevector);
+    bind("bytevector-u8-ref", primitiveBytevectorU8Ref);
+    bind("bytevector-u8-set!", primitiveBytevectorU8Set);
+    bind("bytevector-s8-ref", primitiveBytevectorS8Ref);
+    bind("bytevector-s8-set!", primitiveBytevectorS8Set);
+    bind("bytevector-u16-ref", primitiveBytevectorU16Ref);
+    bind("bytevector-u16-set!", primitiveBytevectorU16Set);
+    bind("bytevector-s16-ref", primitiveBytevectorS16Ref);
+    bind("bytevector-s16-set!", primitiveBytevectorS16Set);
+    bind("bytevector-u32-ref", primitiveBytevectorU32Ref);
+    bind("bytevector-u32-set!", primitiveBytevectorU32Set);
+    bind("bytevector-s32-ref", primitiveBytevectorS32Ref);
+    bind("bytevector-s32-set!", primitiveBytevectorS32Set);
+    bind("bytevector-u64-ref", primitiveBytevectorU64Ref);
+    bind("bytevector-u64-set!", primitiveBytevectorU64Set);
+    bind("bytevector-s64-ref", primitiveBytevectorS64Ref);
+    bind("bytevector-s64-set!", primitiveBytevectorS64Set);
+
+    while (typeOf(current) != NULL_TYPE) {
+        Value *result = eval(resolve(car(current)), globalFrame);
         int needsClose = 0;
         printingHelper(result);
-        if (result -> type != VOID_TYPE) {
+        if (typeOf(result) != VOID_TYPE) {
             printf("\n");
         }
         current = cdr(current);
     }
+    gcPop(2);
 }
 
 #endif
\ No newline at end of file
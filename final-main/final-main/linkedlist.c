@@ -6,6 +6,8 @@
 #include <string.h>
 #include <assert.h>
 #include "talloc.h"
+#include "gc.h"
+#include "symbol.h"
 
 #ifndef _LINKEDLIST
 #define _LINKEDLIST
@@ -15,11 +17,117 @@
 
 // makeNull
 // params: None
-// returns: A new Value with type NULL_TYPE
+// returns: the empty list, a Value with type NULL_TYPE
+// the empty list is an immediate, so nothing is allocated
 Value *makeNull() {
-    Value *nullValue = talloc(sizeof(Value));
-    nullValue -> type = NULL_TYPE;
-    return nullValue;
+    return NULL_VALUE;
+}
+
+// makeInt
+// params: number - an integer
+// returns: a Value with type INT_TYPE holding the integer
+// the integer is a fixnum immediate if it fits in one, and is only allocated otherwise
+Value *makeInt(int64_t number) {
+    if (FIXNUM_MIN <= number && number <= FIXNUM_MAX) {
+        return fixnum(number);
+    }
+    Value *intValue = talloc(sizeof(Value));
+    intValue -> type = INT_TYPE;
+    intValue -> i = number;
+    return intValue;
+}
+
+// makeDouble
+// params: number - a double
+// returns: a new Value with type DOUBLE_TYPE holding the double
+Value *makeDouble(double number) {
+    Value *doubleValue = talloc(sizeof(Value));
+    doubleValue -> type = DOUBLE_TYPE;
+    doubleValue -> d = number;
+    return doubleValue;
+}
+
+// makeString
+// params: chars - the string's characters; length - how many there are
+// returns: a new Value with type STR_TYPE holding a copy of the characters
+// short strings are copied into the Value itself, longer ones into a StringData that the Value owns, so it is freed
+// along with the Value
+Value *makeString(const char *chars, size_t length) {
+    Value *string = talloc(sizeof(Value));
+    string -> type = STR_TYPE;
+    string -> str.length = (uint32_t)length;
+    char *copy = string -> str.small;
+    if (length >= INLINE_STRING) {
+        struct StringData *data = tallocPayload(string, sizeof(struct StringData) + length + 1);
+        data -> hash = 0;
+        string -> str.data = data;
+        copy = data -> chars;
+    }
+    memcpy(copy, chars, length);
+    copy[length] = '\0';
+    return string;
+}
+
+// makeVector
+// params: length - the number of items; fill - a pointer to the Value every item starts out as
+// returns: a new Value with type VECTOR_TYPE
+// the items are stored contiguously, so any one of them can be reached in constant time, in storage the Value owns, so
+// the collector frees them along with it
+Value *makeVector(uint32_t length, Value *fill) {
+    Value *vector = talloc(sizeof(Value));
+    Vector *items = tallocPayload(vector, sizeof(Vector) + length * sizeof(ValueRef));
+    items -> length = length;
+    for (uint32_t i = 0; i < length; i++) {
+        items -> items[i] = REF(fill);
+    }
+    vector -> type = VECTOR_TYPE;
+    vector -> vec = items;
+    return vector;
+}
+
+// vectorRef
+// params: vector - a pointer to a Value with type VECTOR_TYPE; index - which item to get
+// returns: a pointer to the Value at that index
+// Throws an error if vector is not a vector or index is out of range.
+Value *vectorRef(Value *vector, uint32_t index) {
+    assert(typeOf(vector) == VECTOR_TYPE);
+    assert(index < vector -> vec -> length);
+    return VALUE_AT(vector -> vec -> items[index]);
+}
+
+// vectorSet
+// params: vector - a pointer to a Value with type VECTOR_TYPE; index - which item to replace; item - its new Value
+// returns: Nothing
+// Throws an error if vector is not a vector or index is out of range. Tells the garbage collector about the write.
+void vectorSet(Value *vector, uint32_t index, Value *item) {
+    assert(typeOf(vector) == VECTOR_TYPE);
+    assert(index < vector -> vec -> length);
+    vector -> vec -> items[index] = REF(item);
+    gcRecordWrite(vector, false, item);
+}
+
+// foldHash
+// params: hash - a 64-bit hash
+// returns: the hash folded to 32 bits, and never 0, which StringData uses to mean no hash yet
+uint32_t foldHash(uint64_t hash) {
+    uint32_t folded = (uint32_t)(hash ^ (hash >> 32));
+    return folded == 0 ? 1 : folded;
+}
+
+// stringHash
+// params: string - a Value with type STR_TYPE
+// returns: a nonzero hash of the string's characters
+// a long string's hash is worked out once and kept in its StringData; a short one is cheap enough to hash every time
+uint32_t stringHash(Value *string) {
+    assert(typeOf(string) == STR_TYPE);
+    if (string -> str.length < INLINE_STRING) {
+        return foldHash(hashBytes(string -> str.small, string -> str.length));
+    }
+    struct StringData *data = string -> str.data;
+    if (data -> hash == 0) {
+        data -> hash = foldHash(hashBytes(data -> chars, string -> str.length));
+    }
+    return data -> hash;
 }
 
 // Cons
@@ -29,27 +137,79 @@ Value *makeNull() {
 Value *cons(Value *newCar, Value *newCdr) {
     Value *consCell = talloc(sizeof(Value));
     consCell -> type = CONS_TYPE;
-    consCell -> c.car = newCar;
-    consCell -> c.cdr = newCdr;
+    consCell -> c.car = REF(newCar);
+    consCell -> c.cdr = REF(newCdr);
     return consCell;
 }
 
+// A CDR-coded list is split into runs of at most this many cells, so that no run is too big for tallocStatic.
+#define RUN_LENGTH 512
+
+// car reads a CDR-coded cell's car through a Value, so the two have to line up.
+_Static_assert(offsetof(struct CompactCell, car) == offsetof(Value, c.car), "CompactCell must start like a cons cell");
+
+// staticList
+// params: items - an array of pointers to Values that aren't managed by the garbage collector; count - how many
+// returns: a new CDR-coded list of the items, or the empty list if count is 0
+// each run but the last ends in an ordinary cons cell pointing at the next run; the runs are built from the back so
+// that that cell's cdr is already there when it is filled in
+Value *staticList(Value **items, size_t count) {
+    Value *list = makeNull();
+    size_t end = count;
+    while (end > 0) {
+        size_t start = end > RUN_LENGTH ? end - RUN_LENGTH : 0;
+        bool last = end == count;
+        size_t size = (end - start - 1) * sizeof(struct CompactCell) + (last ? sizeof(struct CompactCell) : sizeof(Value));
+        struct CompactCell *cells = tallocStatic(size);
+        for (size_t i = start; i < end - 1; i++) {
+            cells[i - start].type = CDR_NEXT_TYPE;
+            cells[i - start].car = REF(items[i]);
+        }
+        Value *tail = (Value *)&cells[end - 1 - start];
+        tail -> type = last ? CDR_NIL_TYPE : CONS_TYPE;
+        tail -> c.car = REF(items[end - 1]);
+        if (!last) {
+            tail -> c.cdr = REF(list);
+        }
+        list = (Value *)cells;
+        end = start;
+    }
+    return list;
+}
+
 // car
 // params: list - a pointer to a Value
 // returns: a pointer to a Value
 // car returns the car of the given Value. Throws an error if list is not of type CONS_TYPE.
 Value *car(Value *list) {
-    assert(list -> type == CONS_TYPE);
-    return list -> c.car;
+    assert(typeOf(list) == CONS_TYPE);
+    return VALUE_AT(list -> c.car);
 }
 
 // cdr
 // params: list - a pointer to a Value
 // returns: a pointer to a Value
-// cdr returns the cdr of the given Value. Throws an error if list is not of type CONS_TYPE.
+// cdr returns the cdr of the given Value, which for a cell of a CDR-coded list is the next cell or the empty list.
+// Throws an error if list is not of type CONS_TYPE.
 Value *cdr(Value *list) {
-    assert(list -> type == CONS_TYPE);
-    return list -> c.cdr;
+    assert(typeOf(list) == CONS_TYPE);
+    if (list -> type == CDR_NEXT_TYPE) {
+        return (Value *)((struct CompactCell *)list + 1);
+    } else if (list -> type == CDR_NIL_TYPE) {
+        return makeNull();
+    }
+    return VALUE_AT(list -> c.cdr);
+}
+
+// setCdr
+// params: list - a pointer to a Value; newCdr - a pointer to a Value
+// returns: Nothing
+// setCdr replaces the cdr of the given Value, telling the garbage collector about the write. Throws an error if
+// list is not an ordinary cons cell; a cell of a CDR-coded list has no cdr of its own to replace.
+void setCdr(Value *list, Value *newCdr) {
+    assert(typeOf(list) == CONS_TYPE && list -> type == CONS_TYPE);
+    list -> c.cdr = REF(newCdr);
+    gcRecordWrite(list, false, newCdr);
 }
 
 // displayHelper
@@ -58,15 +218,15 @@ Value *cdr(Value *list) {
 // Helper method called by display() to print the items in list.
 void displayHelper(Value *list, int index) {
     Value *currentList = list;
-    switch (currentList -> type) {
+    switch (typeOf(currentList)) {
         case INT_TYPE:
-            printf("Integer at index %i: %i\n", index, currentList -> i);
+            printf("Integer at index %i: %lld\n", index, (long long)intOf(currentList));
             break;
         case DOUBLE_TYPE:
             printf("Double at index %i: %lf\n", index, currentList -> d);
             break;
         case STR_TYPE:
-            printf("String at index %i: %s\n", index, currentList -> s);
+            printf("String at index %i: \"%s\"\n", index, stringChars(currentList));
             break;
         case PTR_TYPE:
             printf("Pointer at index %i\n", index);
@@ -78,14 +238,14 @@ void displayHelper(Value *list, int index) {
             printf("Close parenthesis at index %i: %s\n", index, currentList -> s);
             break;
         case BOOL_TYPE:
-            printf("Boolean at index %i: %i\n", index, currentList -> i);
+            printf("Boolean at index %i: %i\n", index, currentList == TRUE_VALUE);
             break;
         case SYMBOL_TYPE:
             printf("Symbol at index %i: %s\n", index, currentList -> s);
             break;
         case CONS_TYPE:
-            displayHelper(currentList -> c.car, index);
-            displayHelper(currentList -> c.cdr, index + 1);
+            displayHelper(car(currentList), index);
+            displayHelper(cdr(currentList), index + 1);
             break;
         case NULL_TYPE:
             printf("Null at index %i\n", index);
@@ -108,7 +268,7 @@ void display(Value *list) {
 // returns: a pointer to a Value
 // helper method called by reverse() to create a reversed version of list.
 Value *reverseHelper(Value *list, Value *reversed) {
-    switch (list -> type) {
+    switch (typeOf(list)) {
         case NULL_TYPE:
             return reversed;
         case INT_TYPE:
@@ -128,11 +288,11 @@ Value *reverseHelper(Value *list, Value *reversed) {
         case SYMBOL_TYPE:
             return list;
         case CONS_TYPE:
-            reversed = cons(reverseHelper(list -> c.car, reversed), reversed);
-            if (cdr(list) -> type == NULL_TYPE || cdr(list) -> type == CONS_TYPE) {
-                return reverseHelper(list -> c.cdr, reversed);
+            reversed = cons(reverseHelper(car(list), reversed), reversed);
+            if (typeOf(cdr(list)) == NULL_TYPE || typeOf(cdr(list)) == CONS_TYPE) {
+                return reverseHelper(cdr(list), reversed);
             } else {
-                return cons(reverseHelper(list -> c.cdr, reversed), reversed);
+                return cons(reverseHelper(cdr(list), reversed), reversed);
             }
         default:
             return list;
@@ -155,7 +315,7 @@ Value *reverse(Value *list) {
 // returns: true or false
 // Returns true if the type of the give Value is of NULL_TYPE, and false otherwise.
 bool isNull(Value *value) {
-    if (value -> type == NULL_TYPE) {
+    if (typeOf(value) == NULL_TYPE) {
         return true;
     } else {
         return false;
@@ -167,14 +327,14 @@ bool isNull(Value *value) {
 // returns: an integer
 // length iteratively finds the number of items in the linked list pointed to by value.
 int length(Value *value) {
-    if (value -> type == NULL_TYPE) {
+    if (typeOf(value) == NULL_TYPE) {
         return 0;
-    } else if (value -> type == CONS_TYPE) {
+    } else if (typeOf(value) == CONS_TYPE) {
         int count = 1;
         Value *current = value;
         Value *next = cdr(value);
 
-        while (next -> type != NULL_TYPE) {
+        while (typeOf(next) != NULL_TYPE) {
             current = next;
             next = cdr(next);
             count++;
@@ -1,15 +1,49 @@
 #include <stdbool.h>
+#include <stddef.h>
 #include "value.h"
 
 #ifndef _LINKEDLIST
 #define _LINKEDLIST
 
-// Create a new NULL_TYPE value node.
+// Return the empty list. It is an immediate (see value.h), so this doesn't
+// allocate.
 Value *makeNull();
 
+// Return an INT_TYPE value holding number, which is an immediate unless
+// number is too big to fit in one.
+Value *makeInt(int64_t number);
+
+// Return a new DOUBLE_TYPE value holding number.
+Value *makeDouble(double number);
+
+// Return a new STR_TYPE value holding a copy of the length characters at
+// chars, which needn't be NUL-terminated.
+Value *makeString(const char *chars, size_t length);
+
+// Return the hash of a STR_TYPE value's characters. It is never 0, and a long
+// string only works it out once.
+uint32_t stringHash(Value *string);
+
+// Return a new VECTOR_TYPE value with room for length items, all of them fill.
+Value *makeVector(uint32_t length, Value *fill);
+
+// Return the item at index in a vector. Use assertions to make sure that this
+// is a legitimate operation.
+Value *vectorRef(Value *vector, uint32_t index);
+
+// Replace the item at index in a vector. Use assertions to make sure that this
+// is a legitimate operation. Like setCdr, this tells the garbage collector.
+void vectorSet(Value *vector, uint32_t index, Value *item);
+
 // Create a new CONS_TYPE value node.
 Value *cons(Value *newCar, Value *newCdr);
 
+// Return a new CDR-coded list (see struct CompactCell in value.h) of the count
+// Values at items, or the empty list if count is 0. Its cells are allocated
+// with tallocStatic, so the items must not be Values the garbage collector
+// manages either, and the list can never be changed.
+Value *staticList(Value **items, size_t count);
+
 // Display the contents of the linked list to the screen in some kind of
 // readable format
 void display(Value *list);
@@ -28,6 +62,11 @@ Value *car(Value *list);
 // that this is a legitimate operation.
 Value *cdr(Value *list);
 
+// Replace the cdr of a cons cell in place. Use assertions to make sure that
+// this is a legitimate operation. Always use this rather than assigning to
+// c.cdr directly, so that the garbage collector hears about the write.
+void setCdr(Value *list, Value *newCdr);
+
 // Utility to check if pointing to a NULL_TYPE value. Use assertions to make sure
 // that this is a legitimate operation.
 bool isNull(Value *value);
@@ -8,8 +8,15 @@
 
 int main() {
 
-    Value *list = tokenize();
+    // the tokens are only needed until the parse tree is built, so they get
+    // a context of their own that is freed as soon as parsing is done
+    TallocContext *tokenContext = tcontextNew(NULL);
+    TallocContext *treeContext = tcontextSwitch(tokenContext);
+    Value *list = tokenize(treeContext);
+    tcontextSwitch(treeContext);
+
     Value *tree = parse(list);
+    tcontextFree(tokenContext);
     interpret(tree);
 
     tfree();
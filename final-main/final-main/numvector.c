@@ -0,0 +1,626 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include "value.h"
+#include "talloc.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_X86_SIMD 1
+#endif
+
+#ifndef _NUMVECTOR
+#define _NUMVECTOR
+
+// The kernels below come in up to three versions: plain C, SSE2 and AVX2. The
+// first call picks the best one the processor supports (or the one that
+// SCHEME_SIMD names: scalar, sse2 or avx2, whichever is lower) and every call
+// after that goes straight through the Kernels table.
+//
+// Sums and dot products of doubles are kept as LANES partial sums, element i
+// going into sum i % LANES, which are then added up pairwise. Every version
+// splits the work the same way, 16 doubles being four AVX2 registers or eight
+// SSE2 ones, so the result doesn't depend on which version ran.
+
+#define LANES 16
+
+typedef struct Kernels {
+    void (*f64Add)(double *out, const double *a, const double *b, size_t n);
+    void (*f64Multiply)(double *out, const double *a, const double *b, size_t n);
+    void (*f64Scale)(double *out, const double *a, double factor, size_t n);
+    void (*f64SumLanes)(double *lanes, const double *a, size_t n);
+    void (*f64DotLanes)(double *lanes, const double *a, const double *b, size_t n);
+    double (*f64Min)(const double *a, size_t n);
+    double (*f64Max)(const double *a, size_t n);
+    bool (*s64Add)(int64_t *out, const int64_t *a, const int64_t *b, size_t n);
+    bool (*s64Sum)(int64_t *sum, const int64_t *a, size_t n);
+    int64_t (*s64Min)(const int64_t *a, size_t n);
+    int64_t (*s64Max)(const int64_t *a, size_t n);
+} Kernels;
+
+Kernels kernels;
+pthread_once_t kernelsOnce = PTHREAD_ONCE_INIT;
+
+// scalarF64Add, scalarF64Multiply, scalarF64Scale
+// params: out - where the n results go; a, b - the n operands (or a and factor)
+// returns: Nothing
+void scalarF64Add(double *out, const double *a, const double *b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = a[i] + b[i];
+    }
+}
+
+void scalarF64Multiply(double *out, const double *a, const double *b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = a[i] * b[i];
+    }
+}
+
+void scalarF64Scale(double *out, const double *a, double factor, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = a[i] * factor;
+    }
+}
+
+// scalarF64SumLanes, scalarF64DotLanes
+// params: lanes - LANES partial sums, zeroed by the caller; a, b - n doubles
+// returns: Nothing
+// adds the elements (or products) of each full group of LANES into the partial sums; the caller does the rest
+void scalarF64SumLanes(double *lanes, const double *a, size_t n) {
+    for (size_t i = 0; i + LANES <= n; i += LANES) {
+        for (int lane = 0; lane < LANES; lane++) {
+            lanes[lane] += a[i + lane];
+        }
+    }
+}
+
+void scalarF64DotLanes(double *lanes, const double *a, const double *b, size_t n) {
+    for (size_t i = 0; i + LANES <= n; i += LANES) {
+        for (int lane = 0; lane < LANES; lane++) {
+            lanes[lane] += a[i + lane] * b[i + lane];
+        }
+    }
+}
+
+// scalarF64Min, scalarF64Max
+// params: a - n doubles, n at least 1
+// returns: the smallest (or largest) of them
+double scalarF64Min(const double *a, size_t n) {
+    double min = a[0];
+    for (size_t i = 1; i < n; i++) {
+        min = a[i] < min ? a[i] : min;
+    }
+    return min;
+}
+
+double scalarF64Max(const double *a, size_t n) {
+    double max = a[0];
+    for (size_t i = 1; i < n; i++) {
+        max = a[i] > max ? a[i] : max;
+    }
+    return max;
+}
+
+// scalarS64Add
+// params: out - where the n sums go; a, b - the n operands
+// returns: false if any of the sums doesn't fit in 64 bits
+bool scalarS64Add(int64_t *out, const int64_t *a, const int64_t *b, size_t n) {
+    bool overflow = false;
+    for (size_t i = 0; i < n; i++) {
+        overflow |= __builtin_add_overflow(a[i], b[i], &out[i]);
+    }
+    return !overflow;
+}
+
+// scalarS64Sum
+// params: sum - where the total goes; a - n integers
+// returns: false if the total (or a partial sum along the way) doesn't fit in 64 bits
+bool scalarS64Sum(int64_t *sum, const int64_t *a, size_t n) {
+    int64_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (__builtin_add_overflow(total, a[i], &total)) {
+            return false;
+        }
+    }
+    *sum = total;
+    return true;
+}
+
+// scalarS64Min, scalarS64Max
+// params: a - n integers, n at least 1
+// returns: the smallest (or largest) of them
+int64_t scalarS64Min(const int64_t *a, size_t n) {
+    int64_t min = a[0];
+    for (size_t i = 1; i < n; i++) {
+        min = a[i] < min ? a[i] : min;
+    }
+    return min;
+}
+
+int64_t scalarS64Max(const int64_t *a, size_t n) {
+    int64_t max = a[0];
+    for (size_t i = 1; i < n; i++) {
+        max = a[i] > max ? a[i] : max;
+    }
+    return max;
+}
+
+#ifdef HAVE_X86_SIMD
+
+// sse2F64Add, sse2F64Multiply, sse2F64Scale, sse2F64SumLanes, sse2F64DotLanes, sse2F64Min, sse2F64Max, sse2S64Add,
+// sse2S64Sum
+// The SSE2 versions of the kernels above, two elements at a time; the odd element at the end (and, for the lanes
+// kernels, the last partial group) is left to the scalar code.
+__attribute__((target("sse2")))
+void sse2F64Add(double *out, const double *a, const double *b, size_t n) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(out + i, _mm_add_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    }
+    scalarF64Add(out + i, a + i, b + i, n - i);
+}
+
+__attribute__((target("sse2")))
+void sse2F64Multiply(double *out, const double *a, const double *b, size_t n) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(out + i, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    }
+    scalarF64Multiply(out + i, a + i, b + i, n - i);
+}
+
+__attribute__((target("sse2")))
+void sse2F64Scale(double *out, const double *a, double factor, size_t n) {
+    __m128d scale = _mm_set1_pd(factor);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(out + i, _mm_mul_pd(_mm_loadu_pd(a + i), scale));
+    }
+    scalarF64Scale(out + i, a + i, factor, n - i);
+}
+
+__attribute__((target("sse2")))
+void sse2F64SumLanes(double *lanes, const double *a, size_t n) {
+    __m128d sums[LANES / 2];
+    for (int r = 0; r < LANES / 2; r++) {
+        sums[r] = _mm_loadu_pd(lanes + 2 * r);
+    }
+    for (size_t i = 0; i + LANES <= n; i += LANES) {
+        for (int r = 0; r < LANES / 2; r++) {
+            sums[r] = _mm_add_pd(sums[r], _mm_loadu_pd(a + i + 2 * r));
+        }
+    }
+    for (int r = 0; r < LANES / 2; r++) {
+        _mm_storeu_pd(lanes + 2 * r, sums[r]);
+    }
+}
+
+__attribute__((target("sse2")))
+void sse2F64DotLanes(double *lanes, const double *a, const double *b, size_t n) {
+    __m128d sums[LANES / 2];
+    for (int r = 0; r < LANES / 2; r++) {
+        sums[r] = _mm_loadu_pd(lanes + 2 * r);
+    }
+    for (size_t i = 0; i + LANES <= n; i += LANES) {
+        for (int r = 0; r < LANES / 2; r++) {
+            __m128d product = _mm_mul_pd(_mm_loadu_pd(a + i + 2 * r), _mm_loadu_pd(b + i + 2 * r));
+            sums[r] = _mm_add_pd(sums[r], product);
+        }
+    }
+    for (int r = 0; r < LANES / 2; r++) {
+        _mm_storeu_pd(lanes + 2 * r, sums[r]);
+    }
+}
+
+__attribute__((target("sse2")))
+double sse2F64Min(const double *a, size_t n) {
+    __m128d min = _mm_set1_pd(a[0]);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        min = _mm_min_pd(_mm_loadu_pd(a + i), min);
+    }
+    double pair[2];
+    _mm_storeu_pd(pair, min);
+    double rest = i < n ? scalarF64Min(a + i, n - i) : pair[0];
+    return scalarF64Min((double[]){pair[0], pair[1], rest}, 3);
+}
+
+__attribute__((target("sse2")))
+double sse2F64Max(const double *a, size_t n) {
+    __m128d max = _mm_set1_pd(a[0]);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        max = _mm_max_pd(_mm_loadu_pd(a + i), max);
+    }
+    double pair[2];
+    _mm_storeu_pd(pair, max);
+    double rest = i < n ? scalarF64Max(a + i, n - i) : pair[0];
+    return scalarF64Max((double[]){pair[0], pair[1], rest}, 3);
+}
+
+// a sum overflowed exactly when it has a different sign from both operands, so the sign bit of
+// (x ^ sum) & (y ^ sum) is set in every lane that overflowed
+__attribute__((target("sse2")))
+bool sse2S64Add(int64_t *out, const int64_t *a, const int64_t *b, size_t n) {
+    __m128i overflow = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i y = _mm_loadu_si128((const __m128i *)(b + i));
+        __m128i sum = _mm_add_epi64(x, y);
+        overflow = _mm_or_si128(overflow, _mm_and_si128(_mm_xor_si128(x, sum), _mm_xor_si128(y, sum)));
+        _mm_storeu_si128((__m128i *)(out + i), sum);
+    }
+    bool fits = _mm_movemask_pd(_mm_castsi128_pd(overflow)) == 0;
+    return scalarS64Add(out + i, a + i, b + i, n - i) && fits;
+}
+
+__attribute__((target("sse2")))
+bool sse2S64Sum(int64_t *sum, const int64_t *a, size_t n) {
+    __m128i total = _mm_setzero_si128();
+    __m128i overflow = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i next = _mm_add_epi64(total, x);
+        overflow = _mm_or_si128(overflow, _mm_and_si128(_mm_xor_si128(total, next), _mm_xor_si128(x, next)));
+        total = next;
+    }
+    if (_mm_movemask_pd(_mm_castsi128_pd(overflow)) != 0) {
+        return false;
+    }
+    int64_t pair[2];
+    _mm_storeu_si128((__m128i *)pair, total);
+    int64_t rest;
+    return scalarS64Sum(&rest, a + i, n - i)
+        && !__builtin_add_overflow(pair[0], pair[1], sum)
+        && !__builtin_add_overflow(*sum, rest, sum);
+}
+
+// avx2F64Add, avx2F64Multiply, avx2F64Scale, avx2F64SumLanes, avx2F64DotLanes, avx2F64Min, avx2F64Max, avx2S64Add,
+// avx2S64Sum, avx2S64Min, avx2S64Max
+// The AVX2 versions, four elements at a time.
+__attribute__((target("avx2")))
+void avx2F64Add(double *out, const double *a, const double *b, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+    scalarF64Add(out + i, a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2")))
+void avx2F64Multiply(double *out, const double *a, const double *b, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+    scalarF64Multiply(out + i, a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2")))
+void avx2F64Scale(double *out, const double *a, double factor, size_t n) {
+    __m256d scale = _mm256_set1_pd(factor);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), scale));
+    }
+    scalarF64Scale(out + i, a + i, factor, n - i);
+}
+
+__attribute__((target("avx2")))
+void avx2F64SumLanes(double *lanes, const double *a, size_t n) {
+    __m256d sums[LANES / 4];
+    for (int r = 0; r < LANES / 4; r++) {
+        sums[r] = _mm256_loadu_pd(lanes + 4 * r);
+    }
+    for (size_t i = 0; i + LANES <= n; i += LANES) {
+        for (int r = 0; r < LANES / 4; r++) {
+            sums[r] = _mm256_add_pd(sums[r], _mm256_loadu_pd(a + i + 4 * r));
+        }
+    }
+    for (int r = 0; r < LANES / 4; r++) {
+        _mm256_storeu_pd(lanes + 4 * r, sums[r]);
+    }
+}
+
+__attribute__((target("avx2")))
+void avx2F64DotLanes(double *lanes, const double *a, const double *b, size_t n) {
+    __m256d sums[LANES / 4];
+    for (int r = 0; r < LANES / 4; r++) {
+        sums[r] = _mm256_loadu_pd(lanes + 4 * r);
+    }
+    for (size_t i = 0; i + LANES <= n; i += LANES) {
+        for (int r = 0; r < LANES / 4; r++) {
+            // a separate multiply and add rather than a fused one, to round the same way as the other versions
+            __m256d product = _mm256_mul_pd(_mm256_loadu_pd(a + i + 4 * r), _mm256_loadu_pd(b + i + 4 * r));
+            sums[r] = _mm256_add_pd(sums[r], product);
+        }
+    }
+    for (int r = 0; r < LANES / 4; r++) {
+        _mm256_storeu_pd(lanes + 4 * r, sums[r]);
+    }
+}
+
+__attribute__((target("avx2")))
+double avx2F64Min(const double *a, size_t n) {
+    __m256d min = _mm256_set1_pd(a[0]);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        min = _mm256_min_pd(_mm256_loadu_pd(a + i), min);
+    }
+    double quad[5];
+    _mm256_storeu_pd(quad, min);
+    quad[4] = i < n ? scalarF64Min(a + i, n - i) : quad[0];
+    return scalarF64Min(quad, 5);
+}
+
+__attribute__((target("avx2")))
+double avx2F64Max(const double *a, size_t n) {
+    __m256d max = _mm256_set1_pd(a[0]);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        max = _mm256_max_pd(_mm256_loadu_pd(a + i), max);
+    }
+    double quad[5];
+    _mm256_storeu_pd(quad, max);
+    quad[4] = i < n ? scalarF64Max(a + i, n - i) : quad[0];
+    return scalarF64Max(quad, 5);
+}
+
+__attribute__((target("avx2")))
+bool avx2S64Add(int64_t *out, const int64_t *a, const int64_t *b, size_t n) {
+    __m256i overflow = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(b + i));
+        __m256i sum = _mm256_add_epi64(x, y);
+        overflow = _mm256_or_si256(overflow, _mm256_and_si256(_mm256_xor_si256(x, sum), _mm256_xor_si256(y, sum)));
+        _mm256_storeu_si256((__m256i *)(out + i), sum);
+    }
+    bool fits = _mm256_movemask_pd(_mm256_castsi256_pd(overflow)) == 0;
+    return scalarS64Add(out + i, a + i, b + i, n - i) && fits;
+}
+
+__attribute__((target("avx2")))
+bool avx2S64Sum(int64_t *sum, const int64_t *a, size_t n) {
+    __m256i total = _mm256_setzero_si256();
+    __m256i overflow = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i next = _mm256_add_epi64(total, x);
+        overflow = _mm256_or_si256(overflow, _mm256_and_si256(_mm256_xor_si256(total, next), _mm256_xor_si256(x, next)));
+        total = next;
+    }
+    if (_mm256_movemask_pd(_mm256_castsi256_pd(overflow)) != 0) {
+        return false;
+    }
+    int64_t quad[5];
+    _mm256_storeu_si256((__m256i *)quad, total);
+    if (!scalarS64Sum(&quad[4], a + i, n - i)) {
+        return false;
+    }
+    return scalarS64Sum(sum, quad, 5);
+}
+
+__attribute__((target("avx2")))
+int64_t avx2S64Min(const int64_t *a, size_t n) {
+    __m256i min = _mm256_set1_epi64x(a[0]);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        min = _mm256_blendv_epi8(min, x, _mm256_cmpgt_epi64(min, x));
+    }
+    int64_t quad[5];
+    _mm256_storeu_si256((__m256i *)quad, min);
+    quad[4] = i < n ? scalarS64Min(a + i, n - i) : quad[0];
+    return scalarS64Min(quad, 5);
+}
+
+__attribute__((target("avx2")))
+int64_t avx2S64Max(const int64_t *a, size_t n) {
+    __m256i max = _mm256_set1_epi64x(a[0]);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        max = _mm256_blendv_epi8(max, x, _mm256_cmpgt_epi64(x, max));
+    }
+    int64_t quad[5];
+    _mm256_storeu_si256((__m256i *)quad, max);
+    quad[4] = i < n ? scalarS64Max(a + i, n - i) : quad[0];
+    return scalarS64Max(quad, 5);
+}
+
+#endif
+
+// chooseKernels
+// params: None
+// returns: Nothing
+// fills in the Kernels table with the best versions this processor and SCHEME_SIMD allow; SSE2 has no 64-bit
+// integer comparison, so the integer min and max stay scalar below AVX2
+void chooseKernels() {
+    kernels = (Kernels){scalarF64Add, scalarF64Multiply, scalarF64Scale, scalarF64SumLanes,
+        scalarF64DotLanes, scalarF64Min, scalarF64Max, scalarS64Add, scalarS64Sum, scalarS64Min, scalarS64Max};
+#ifdef HAVE_X86_SIMD
+    const char *setting = getenv("SCHEME_SIMD");
+    bool allowSse2 = setting == NULL || strcmp(setting, "scalar") != 0;
+    bool allowAvx2 = setting == NULL || strcmp(setting, "avx2") == 0;
+    __builtin_cpu_init();
+    if (allowSse2 && __builtin_cpu_supports("sse2")) {
+        kernels = (Kernels){sse2F64Add, sse2F64Multiply, sse2F64Scale, sse2F64SumLanes,
+            sse2F64DotLanes, sse2F64Min, sse2F64Max, sse2S64Add, sse2S64Sum, scalarS64Min, scalarS64Max};
+    }
+    if (allowAvx2 && __builtin_cpu_supports("avx2")) {
+        kernels = (Kernels){avx2F64Add, avx2F64Multiply, avx2F64Scale, avx2F64SumLanes,
+            avx2F64DotLanes, avx2F64Min, avx2F64Max, avx2S64Add, avx2S64Sum, avx2S64Min, avx2S64Max};
+    }
+#endif
+}
+
+// activeKernels
+// params: None
+// returns: a pointer to the Kernels table, chosen on the first call
+Kernels *activeKernels() {
+    pthread_once(&kernelsOnce, chooseKernels);
+    return &kernels;
+}
+
+// makeF64Vector
+// params: length - the number of items
+// returns: a new Value with type F64VECTOR_TYPE whose items are all 0.0
+Value *makeF64Vector(uint32_t length) {
+    Value *vector = talloc(sizeof(Value));
+    struct F64Vector *items = tallocPayload(vector, sizeof(struct F64Vector) + length * sizeof(double));
+    items -> length = length;
+    memset(items -> items, 0, length * sizeof(double));
+    vector -> type = F64VECTOR_TYPE;
+    vector -> f64v = items;
+    return vector;
+}
+
+// makeS64Vector
+// params: length - the number of items
+// returns: a new Value with type S64VECTOR_TYPE whose items are all 0
+Value *makeS64Vector(uint32_t length) {
+    Value *vector = talloc(sizeof(Value));
+    struct S64Vector *items = tallocPayload(vector, sizeof(struct S64Vector) + length * sizeof(int64_t));
+    items -> length = length;
+    memset(items -> items, 0, length * sizeof(int64_t));
+    vector -> type = S64VECTOR_TYPE;
+    vector -> s64v = items;
+    return vector;
+}
+
+// f64Add, f64Multiply, f64Scale
+// params: out - where the n results go; a, b - the n operands (or a and factor)
+// returns: Nothing
+void f64Add(double *out, const double *a, const double *b, size_t n) {
+    activeKernels() -> f64Add(out, a, b, n);
+}
+
+void f64Multiply(double *out, const double *a, const double *b, size_t n) {
+    activeKernels() -> f64Multiply(out, a, b, n);
+}
+
+void f64Scale(double *out, const double *a, double factor, size_t n) {
+    activeKernels() -> f64Scale(out, a, factor, n);
+}
+
+// finishLanes
+// params: lanes - LANES partial sums
+// returns: their total, added up pairwise
+double finishLanes(double *lanes) {
+    for (int width = LANES / 2; width > 0; width /= 2) {
+        for (int lane = 0; lane < width; lane++) {
+            lanes[lane] += lanes[lane + width];
+        }
+    }
+    return lanes[0];
+}
+
+// f64Sum
+// params: a - n doubles
+// returns: their sum
+double f64Sum(const double *a, size_t n) {
+    double lanes[LANES] = {0};
+    activeKernels() -> f64SumLanes(lanes, a, n);
+    size_t full = n - n % LANES;
+    for (size_t i = full; i < n; i++) {
+        lanes[i - full] += a[i];
+    }
+    return finishLanes(lanes);
+}
+
+// f64Dot
+// params: a, b - n doubles each
+// returns: the sum of their products
+double f64Dot(const double *a, const double *b, size_t n) {
+    double lanes[LANES] = {0};
+    activeKernels() -> f64DotLanes(lanes, a, b, n);
+    size_t full = n - n % LANES;
+    for (size_t i = full; i < n; i++) {
+        lanes[i - full] += a[i] * b[i];
+    }
+    return finishLanes(lanes);
+}
+
+// f64Min, f64Max
+// params: a - n doubles, n at least 1
+// returns: the smallest (or largest) of them
+double f64Min(const double *a, size_t n) {
+    return activeKernels() -> f64Min(a, n);
+}
+
+double f64Max(const double *a, size_t n) {
+    return activeKernels() -> f64Max(a, n);
+}
+
+// s64Add
+// params: out - where the n sums go; a, b - the n operands
+// returns: false if any of the sums doesn't fit in 64 bits
+bool s64Add(int64_t *out, const int64_t *a, const int64_t *b, size_t n) {
+    return activeKernels() -> s64Add(out, a, b, n);
+}
+
+// s64Multiply
+// params: out - where the n products go; a, b - the n operands
+// returns: false if any of the products doesn't fit in 64 bits
+// there is no 64-bit vector multiply before AVX-512, so this is always scalar
+bool s64Multiply(int64_t *out, const int64_t *a, const int64_t *b, size_t n) {
+    bool overflow = false;
+    for (size_t i = 0; i < n; i++) {
+        overflow |= __builtin_mul_overflow(a[i], b[i], &out[i]);
+    }
+    return !overflow;
+}
+
+// s64Scale
+// params: out - where the n products go; a - n integers; factor - what to multiply each by
+// returns: false if any of the products doesn't fit in 64 bits
+bool s64Scale(int64_t *out, const int64_t *a, int64_t factor, size_t n) {
+    bool overflow = false;
+    for (size_t i = 0; i < n; i++) {
+        overflow |= __builtin_mul_overflow(a[i], factor, &out[i]);
+    }
+    return !overflow;
+}
+
+// s64Sum
+// params: sum - where the total goes; a - n integers
+// returns: false if the total, or one of the partial sums along the way, doesn't fit in 64 bits
+bool s64Sum(int64_t *sum, const int64_t *a, size_t n) {
+    return activeKernels() -> s64Sum(sum, a, n);
+}
+
+// s64Dot
+// params: dot - where the result goes; a, b - n integers each
+// returns: false if the sum of the products, or anything along the way, doesn't fit in 64 bits
+bool s64Dot(int64_t *dot, const int64_t *a, const int64_t *b, size_t n) {
+    int64_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        int64_t product;
+        if (__builtin_mul_overflow(a[i], b[i], &product) || __builtin_add_overflow(total, product, &total)) {
+            return false;
+        }
+    }
+    *dot = total;
+    return true;
+}
+
+// s64Min, s64Max
+// params: a - n integers, n at least 1
+// returns: the smallest (or largest) of them
+int64_t s64Min(const int64_t *a, size_t n) {
+    return activeKernels() -> s64Min(a, n);
+}
+
+int64_t s64Max(const int64_t *a, size_t n) {
+    return activeKernels() -> s64Max(a, n);
+}
+
+#endif
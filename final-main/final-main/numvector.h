@@ -0,0 +1,42 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "value.h"
+
+#ifndef _NUMVECTOR
+#define _NUMVECTOR
+
+// Vectors of unboxed doubles (F64VECTOR_TYPE) and 64-bit integers
+// (S64VECTOR_TYPE), and the kernels that work on their items. Each kernel has
+// SSE2 and AVX2 versions as well as a plain C one, and the best one the
+// processor supports is picked at run time; set SCHEME_SIMD to scalar or sse2
+// to use a lower one. Every version gives the same results.
+
+// Return a new vector of length zeros.
+Value *makeF64Vector(uint32_t length);
+Value *makeS64Vector(uint32_t length);
+
+// Store a[i] + b[i], a[i] * b[i] or a[i] * factor in out[i], for each i < n.
+// The integer versions return false if any result doesn't fit in 64 bits.
+void f64Add(double *out, const double *a, const double *b, size_t n);
+void f64Multiply(double *out, const double *a, const double *b, size_t n);
+void f64Scale(double *out, const double *a, double factor, size_t n);
+bool s64Add(int64_t *out, const int64_t *a, const int64_t *b, size_t n);
+bool s64Multiply(int64_t *out, const int64_t *a, const int64_t *b, size_t n);
+bool s64Scale(int64_t *out, const int64_t *a, int64_t factor, size_t n);
+
+// Return the sum of a's n items, or the sum of the products a[i] * b[i]. The
+// integer versions store it in *sum or *dot, and return false instead if it
+// doesn't fit in 64 bits.
+double f64Sum(const double *a, size_t n);
+double f64Dot(const double *a, const double *b, size_t n);
+bool s64Sum(int64_t *sum, const int64_t *a, size_t n);
+bool s64Dot(int64_t *dot, const int64_t *a, const int64_t *b, size_t n);
+
+// Return the smallest or largest of a's n items; n must be at least 1.
+double f64Min(const double *a, size_t n);
+double f64Max(const double *a, size_t n);
+int64_t s64Min(const int64_t *a, size_t n);
+int64_t s64Max(const int64_t *a, size_t n);
+
+#endif
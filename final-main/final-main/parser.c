@@ -2,6 +2,7 @@
 #include "value.h"
 #include "linkedlist.h"
 #include "talloc.h"
+#include "bignum.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -27,6 +28,24 @@ void syntaxError(int depth) {
     }
 }
 
+// context that the parser's stack cells are allocated in while parse() runs;
+// none of them are part of the finished tree, so the whole context is freed
+// once the tree is built
+TallocContext *stackContext = NULL;
+
+/*
+stackPush
+params: stack - a Value struct, item - a Value struct
+returns: stack - a Value struct
+Returns the stack with item on top, allocating the new stack cell in stackContext.
+*/
+Value *stackPush(Value *stack, Value *item) {
+    TallocContext *treeContext = tcontextSwitch(stackContext);
+    stack = cons(item, stack);
+    tcontextSwitch(treeContext);
+    return stack;
+}
+
 /*
 push
 params: tree - a Value struct, token - a Value struct
@@ -35,62 +54,89 @@ Returns a list with the given token pushed onto the top of the given tree.
 */
 Value *push(Value *tree, Value *token) {
 
-    Value *newToken = talloc(sizeof(Value));
+    // open parens only mark where a subtree starts on the stack and never
+    // make it into the tree, and subtrees were built by the parser itself, so
+    // neither needs copying; nor do immediates, which aren't allocated at all
+    if (isImmediate(token) || typeOf(token) == OPEN_TYPE || typeOf(token) == CONS_TYPE) {
+        return stackPush(tree, token);
+    }
 
-    switch (token->type) {
-        case NULL_TYPE:
-            newToken->type = NULL_TYPE;
-            break;
+    // everything in the tree is static, out of the garbage collector's way,
+    // since the tree is needed until the program ends and is never changed
+    Value *newToken = tallocStatic(sizeof(Value));
+
+    switch (typeOf(token)) {
         case INT_TYPE:
             newToken->type = INT_TYPE;
-            newToken->i = token->i;
+            newToken->i = intOf(token);
             break;
         case DOUBLE_TYPE:
             newToken->type = DOUBLE_TYPE;
             newToken->d = token->d;
             break;
         case STR_TYPE:
-            newToken->type = STR_TYPE;
-            char *newString = talloc(sizeof(char)*strlen(token->s)+1);
-            strcpy(newString, token->s);
-            newToken->s = newString;
+            // a long string's characters, like a bignum's digits, belong to
+            // the token, which the collector will free, so the tree's copy
+            // takes them over
+            *newToken = *token;
+            if (token -> str.length >= INLINE_STRING) {
+                tallocPayloadAdopt(token -> str.data, newToken);
+            }
             break;
-        case PTR_TYPE:
+        case BIGNUM_TYPE:
+            *newToken = *token;
+            tallocPayloadAdopt(token -> b, newToken);
             break;
-        case OPEN_TYPE:
-            newToken->type = OPEN_TYPE;
-            char *newOpen = talloc(2*sizeof(char));
-            strcpy(newOpen, "(");
-            newToken->s = newOpen;
+        case PTR_TYPE:
             break;
         case CLOSE_TYPE:
             newToken->type = CLOSE_TYPE;
-            char *newClose = talloc(2*sizeof(char));
+            char *newClose = tallocBytes(2*sizeof(char));
             strcpy(newClose, ")");
             newToken -> s = newClose;
             break;
-        case BOOL_TYPE:
-            newToken->type = BOOL_TYPE;
-            newToken->i = token->i;
-            break;
         case SYMBOL_TYPE:
             newToken->type = SYMBOL_TYPE;
-            char *newSymbol = talloc(sizeof(char)*strlen(token->s)+1);
-            strcpy(newSymbol, token->s);
-            newToken->s = newSymbol;
+            // symbol names are interned, so the name can be shared
+            newToken->s = token->s;
             break;
-        case CONS_TYPE:
-            newToken->type = CONS_TYPE;
-            return cons(token, tree);
         default:
             break;
     }
 
-    tree = cons(newToken, tree);
+    tree = stackPush(tree, newToken);
 
     return tree;
 }
 
+/*
+popList
+params: stack - a pointer to the stack, a Value struct
+returns: a CDR-coded list of the items popped
+Pops items off the stack until it reaches an open paren or the bottom, and returns them, in the order they were
+pushed, as a list laid out in one run of memory (see staticList).
+*/
+Value *popList(Value **stack) {
+    size_t count = 0;
+    for (Value *current = *stack; typeOf(current) != NULL_TYPE && typeOf(car(current)) != OPEN_TYPE; current = cdr(current)) {
+        count++;
+    }
+
+    TallocContext *treeContext = tcontextSwitch(stackContext);
+    Value **items = tallocBytes(count * sizeof(Value *));
+    tcontextSwitch(treeContext);
+
+    // the popped stack cells aren't referenced anywhere else, so hand
+    // them back to be reused by the next push
+    for (size_t i = count; i > 0; i--) {
+        items[i - 1] = car(*stack);
+        Value *popped = *stack;
+        *stack = cdr(*stack);
+        trelease(popped, sizeof(Value));
+    }
+    return staticList(items, count);
+}
+
 /* 
 addToParseTree
 params: tree - a Value struct, depth - a pointer to an integer, token - a Value struct
@@ -101,9 +147,9 @@ the tree into a new list until it reaches an open parenthesis and push that new
 Value *addToParseTree(Value *tree, int *depth, Value *token) {
     // is the token not a close paren?
         // push on the stack
-    if (token->type != CLOSE_TYPE) {
+    if (typeOf(token) != CLOSE_TYPE) {
 
-        if (token->type == OPEN_TYPE) {
+        if (typeOf(token) == OPEN_TYPE) {
             *depth += 1;
         }
         tree = push(tree, token);
@@ -116,16 +162,10 @@ Value *addToParseTree(Value *tree, int *depth, Value *token) {
         if (*depth < 0) {
             syntaxError(*depth);
         }
-        Value *subTree = makeNull();
-        Value *current = tree;
-
-        while (car(current)->type != OPEN_TYPE) {
-            subTree = cons(car(current), subTree);
-            current = current->c.cdr;
-            tree = tree->c.cdr;
-        }
-        
-        tree = tree->c.cdr;
+        Value *subTree = popList(&tree);
+        Value *open = tree;
+        tree = cdr(tree);
+        trelease(open, sizeof(Value));
         tree = push(tree, subTree);
 
     }
@@ -141,13 +181,16 @@ Takes a list of tokens from a Scheme program, and returns a pointer to a parse t
 */
 Value *parse(Value *tokens) {
 
+    stackContext = tcontextNew(tcontextCurrent());
+    TallocContext *treeContext = tcontextSwitch(stackContext);
     Value *tree = makeNull();
+    tcontextSwitch(treeContext);
     int depth = 0;
 
     Value *current = tokens;
     assert(current != NULL && "Error (parse): null pointer");
 
-    while (current->type != NULL_TYPE) {
+    while (typeOf(current) != NULL_TYPE) {
         Value *token = car(current);
         tree = addToParseTree(tree, &depth, token);
         current = cdr(current);
@@ -157,20 +200,12 @@ Value *parse(Value *tokens) {
         syntaxError(depth);
     }
 
-    //reverse the list of parse trees
-    Value *prev = makeNull();
-    current = tree;
-    Value *next = cdr(tree);
-    while (next->type != NULL_TYPE) {
-        current->c.cdr = prev;
-        prev = current;
-        current = next;
-        next = cdr(next);
-    }
-    current->c.cdr = prev;
-    tree = current;
+    //copy the stack of parse trees out of the stack context, which puts them back in order
+    Value *forms = popList(&tree);
+    tcontextFree(stackContext);
+    stackContext = NULL;
 
-    return tree;
+    return forms;
 }
 
 /*
@@ -180,15 +215,21 @@ returns: nothing
 A helper function for printTree() meant to recursively print the given tree.
 */
 void printTreeHelper(Value *tree, int *needsClose) {
-    switch (tree -> type) {
+    switch (typeOf(tree)) {
         case INT_TYPE:
-            printf("%i ", tree->i);
+            printf("%lld ", (long long)intOf(tree));
+            break;
+        case BIGNUM_TYPE: {
+            char *text = integerToString(tree);
+            printf("%s ", text);
+            free(text);
             break;
+        }
         case DOUBLE_TYPE:
             printf("%.2lf ", tree->d);
             break;
         case STR_TYPE:
-            printf("%s ", tree->s);
+            printf("\"%s\" ", stringChars(tree));
             break;
         case PTR_TYPE:
             break;
@@ -197,17 +238,17 @@ void printTreeHelper(Value *tree, int *needsClose) {
         case CLOSE_TYPE:
             break;
         case BOOL_TYPE:
-            if (tree->i == 1) {
+            if (tree == TRUE_VALUE) {
                 printf("#t ");
             } else {
                 printf("#f ");
             }
             break;
         case SYMBOL_TYPE:
-            printf("%s ", tree->s);
+            printf("\"%s\" ", stringChars(tree));
             break;
         case CONS_TYPE:
-            if (car(tree)->type == CONS_TYPE || car(tree)->type == NULL_TYPE) {
+            if (typeOf(car(tree)) == CONS_TYPE || typeOf(car(tree)) == NULL_TYPE) {
                 printf("(");
                 *needsClose += 1;
             }
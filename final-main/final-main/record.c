@@ -0,0 +1,95 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include "value.h"
+#include "talloc.h"
+#include "gc.h"
+
+#ifndef _RECORD
+#define _RECORD
+
+// makeRecordType
+// params: name - the type's interned name; fieldCount - how many fields its records have
+// returns: a new RecordType in the arena, whose fieldNames the caller fills in
+RecordType *makeRecordType(char *name, uint32_t fieldCount) {
+    RecordType *type = tallocBytes(sizeof(RecordType));
+    type -> name = name;
+    type -> fieldCount = fieldCount;
+    type -> fieldNames = tallocBytes(fieldCount * sizeof(char *));
+    return type;
+}
+
+// recordFieldIndex
+// params: type - a pointer to a RecordType; name - an interned field name
+// returns: the index of the field with that name, or type's fieldCount if there is none
+uint32_t recordFieldIndex(RecordType *type, char *name) {
+    uint32_t index = 0;
+    while (index < type -> fieldCount && type -> fieldNames[index] != name) {
+        index++;
+    }
+    return index;
+}
+
+// makeRecordDescriptor
+// params: type - a pointer to a RecordType
+// returns: a new Value with type RECORD_DESCRIPTOR_TYPE
+Value *makeRecordDescriptor(RecordType *type) {
+    Value *descriptor = talloc(sizeof(Value));
+    descriptor -> type = RECORD_DESCRIPTOR_TYPE;
+    descriptor -> rt = type;
+    return descriptor;
+}
+
+// makeRecordProcedure
+// params: kind - what the procedure does; type - the record type it works on; field - the field of an accessor or
+// modifier; argCount - the number of arguments of a constructor
+// returns: a new Value with type RECORD_PROCEDURE_TYPE, whose argFields the caller fills in for a constructor
+Value *makeRecordProcedure(recordProcedureKind kind, RecordType *type, uint32_t field, uint32_t argCount) {
+    struct RecordProcedure *procedure = tallocBytes(sizeof(struct RecordProcedure) + argCount * sizeof(uint32_t));
+    procedure -> kind = kind;
+    procedure -> type = type;
+    procedure -> field = field;
+    procedure -> argCount = argCount;
+    Value *value = talloc(sizeof(Value));
+    value -> type = RECORD_PROCEDURE_TYPE;
+    value -> rp = procedure;
+    return value;
+}
+
+// makeRecord
+// params: type - a pointer to a RecordType
+// returns: a new Value with type RECORD_TYPE whose fields are all unspecified
+// the fields are stored contiguously in a payload of the record, right after the record's type
+Value *makeRecord(RecordType *type) {
+    Value *record = talloc(sizeof(Value));
+    Record *fields = tallocPayload(record, sizeof(Record) + type -> fieldCount * sizeof(ValueRef));
+    fields -> type = type;
+    for (uint32_t i = 0; i < type -> fieldCount; i++) {
+        fields -> fields[i] = REF(UNSPECIFIED_VALUE);
+    }
+    record -> type = RECORD_TYPE;
+    record -> rec = fields;
+    return record;
+}
+
+// recordRef
+// params: record - a pointer to a Value with type RECORD_TYPE; index - which field to get
+// returns: a pointer to the Value in that field
+Value *recordRef(Value *record, uint32_t index) {
+    assert(typeOf(record) == RECORD_TYPE);
+    assert(index < record -> rec -> type -> fieldCount);
+    return VALUE_AT(record -> rec -> fields[index]);
+}
+
+// recordSet
+// params: record - a pointer to a Value with type RECORD_TYPE; index - which field to replace; item - its new Value
+// returns: Nothing
+// Tells the garbage collector about the write.
+void recordSet(Value *record, uint32_t index, Value *item) {
+    assert(typeOf(record) == RECORD_TYPE);
+    assert(index < record -> rec -> type -> fieldCount);
+    record -> rec -> fields[index] = REF(item);
+    gcRecordWrite(record, false, item);
+}
+
+#endif
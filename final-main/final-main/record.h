@@ -0,0 +1,31 @@
+#include <stdint.h>
+#include "value.h"
+
+#ifndef _RECORD
+#define _RECORD
+
+// Return a new record type with the given name and room for fieldCount field
+// names, which the caller fills in.
+RecordType *makeRecordType(char *name, uint32_t fieldCount);
+
+// Return the index of the field of type named name, an interned symbol name,
+// or type's fieldCount if it has no such field.
+uint32_t recordFieldIndex(RecordType *type, char *name);
+
+// Return a new RECORD_DESCRIPTOR_TYPE value standing for type.
+Value *makeRecordDescriptor(RecordType *type);
+
+// Return a new RECORD_PROCEDURE_TYPE value of the given kind for type. field
+// is the field an accessor or modifier works on, and argCount the number of
+// arguments a constructor takes, the fields for which the caller fills in.
+Value *makeRecordProcedure(recordProcedureKind kind, RecordType *type, uint32_t field, uint32_t argCount);
+
+// Return a new record of the given type with every field unspecified.
+Value *makeRecord(RecordType *type);
+
+// Get or set the field at index of record. Like vectorSet, recordSet tells
+// the garbage collector about the write.
+Value *recordRef(Value *record, uint32_t index);
+void recordSet(Value *record, uint32_t index, Value *item);
+
+#endif
@@ -0,0 +1,309 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "value.h"
+#include "linkedlist.h"
+#include "talloc.h"
+#include "symbol.h"
+#include "global.h"
+#include "special.h"
+
+#ifndef _RESOLVER
+#define _RESOLVER
+
+// The variables of one frame that the code being resolved will create, in
+// slot order, and the environment around it (NULL for the global frame).
+typedef struct Environment {
+    struct Environment *parent;
+    Value **names;
+    uint32_t count;
+    uint32_t capacity;
+} Environment;
+
+// define the interned names of the special forms whose parts resolve has to tell apart, filled in on first use
+char *quoteKeyword = NULL;
+char *lambdaKeyword, *letKeyword, *letrecKeyword, *defineKeyword, *setKeyword, *recordKeyword;
+
+Value *resolveExpression(Value *expression, Environment *environment);
+
+// isKeyword
+// params: value - a pointer to a Value; keyword - an interned name
+// returns: true if value is the symbol with that name
+bool isKeyword(Value *value, char *keyword) {
+    return typeOf(value) == SYMBOL_TYPE && value -> s == keyword;
+}
+
+// slotOf
+// params: environment - a pointer to an Environment; name - an interned name
+// returns: the slot of the variable with that name in environment's own frame, or its count if there is none
+uint32_t slotOf(Environment *environment, char *name) {
+    uint32_t slot = 0;
+    while (slot < environment -> count && environment -> names[slot] -> s != name) {
+        slot++;
+    }
+    return slot;
+}
+
+// addName
+// params: environment - a pointer to an Environment; symbol - a pointer to a SYMBOL_TYPE Value
+// returns: Nothing
+// gives the variable a slot at the end of environment's frame, unless it already has one
+void addName(Environment *environment, Value *symbol) {
+    if (slotOf(environment, symbol -> s) < environment -> count) {
+        return;
+    }
+    if (environment -> count == environment -> capacity) {
+        environment -> capacity = environment -> capacity == 0 ? 8 : environment -> capacity * 2;
+        environment -> names = realloc(environment -> names, environment -> capacity * sizeof(Value *));
+        if (environment -> names == NULL) {
+            printf("Evaluation error: out of memory\n");
+            texit(0);
+        }
+    }
+    environment -> names[environment -> count++] = symbol;
+}
+
+// addDefinitions
+// params: form - a pointer to a Value from the parse tree; environment - a pointer to an Environment
+// returns: Nothing
+// gives a slot to every variable that a define or define-record-type in form would add to the frame form runs in;
+// lambda, let and letrec bodies run in frames of their own, and quoted data never runs, so they're skipped
+void addDefinitions(Value *form, Environment *environment) {
+    if (typeOf(form) != CONS_TYPE) {
+        return;
+    }
+    Value *first = car(form);
+    if (isKeyword(first, quoteKeyword) || isKeyword(first, lambdaKeyword) || isKeyword(first, letKeyword)
+        || isKeyword(first, letrecKeyword)) {
+        return;
+    } else if (isKeyword(first, defineKeyword) && typeOf(cdr(form)) == CONS_TYPE && typeOf(car(cdr(form))) == SYMBOL_TYPE) {
+        addName(environment, car(cdr(form)));
+    } else if (isKeyword(first, recordKeyword)) {
+        // the type and the predicate are symbols, the constructor a list of its name and fields, and each field a
+        // list of its name, its accessor and maybe its modifier
+        int index = 0;
+        for (Value *current = cdr(form); typeOf(current) == CONS_TYPE; current = cdr(current), index++) {
+            Value *part = car(current);
+            if ((index == 0 || index == 2) && typeOf(part) == SYMBOL_TYPE) {
+                addName(environment, part);
+            } else if (index == 1 && typeOf(part) == CONS_TYPE && typeOf(car(part)) == SYMBOL_TYPE) {
+                addName(environment, car(part));
+            } else if (index > 2 && typeOf(part) == CONS_TYPE) {
+                for (Value *name = cdr(part); typeOf(name) == CONS_TYPE; name = cdr(name)) {
+                    if (typeOf(car(name)) == SYMBOL_TYPE) {
+                        addName(environment, car(name));
+                    }
+                }
+            }
+        }
+        return;
+    }
+    for (Value *current = cdr(form); typeOf(current) == CONS_TYPE; current = cdr(current)) {
+        addDefinitions(car(current), environment);
+    }
+}
+
+// tagKeyword
+// params: keyword - a pointer to the SYMBOL_TYPE Value at the head of a special form's combination
+// returns: the special form's SPECIAL_FORM_TYPE value (see special.h), or keyword itself if it isn't registered
+Value *tagKeyword(Value *keyword) {
+    Value *special = specialForm(keyword -> s);
+    return special != NULL ? special : keyword;
+}
+
+// tagForm
+// params: form - a special form's combination from the parse tree
+// returns: a new static combination with the same arguments as form, headed by its keyword's tag
+Value *tagForm(Value *form) {
+    Value *tagged = tallocStatic(sizeof(Value));
+    tagged -> type = CONS_TYPE;
+    tagged -> c.car = REF(tagKeyword(car(form)));
+    tagged -> c.cdr = REF(cdr(form));
+    return tagged;
+}
+
+// makeReference
+// params: symbol - a pointer to a SYMBOL_TYPE Value; environment - a pointer to the Environment it appears in
+// returns: a new LOCAL_REF_TYPE value if a frame in environment has the variable, or a GLOBAL_REF_TYPE value if not
+Value *makeReference(Value *symbol, Environment *environment) {
+    Value *reference = tallocStatic(sizeof(Value));
+    uint32_t depth = 0;
+    for (; environment != NULL; environment = environment -> parent, depth++) {
+        uint32_t slot = slotOf(environment, symbol -> s);
+        if (slot < environment -> count) {
+            reference -> type = LOCAL_REF_TYPE;
+            reference -> lr.depth = depth;
+            reference -> lr.slot = slot;
+            reference -> lr.symbol = REF(symbol);
+            return reference;
+        }
+    }
+    reference -> type = GLOBAL_REF_TYPE;
+    reference -> global = globalCell(symbol -> s);
+    return reference;
+}
+
+// makeScope
+// params: environment - a pointer to an Environment; initialized - how many of its variables are parameters or bindings
+// returns: a new SCOPE_TYPE value listing environment's variables
+Value *makeScope(Environment *environment, uint32_t initialized) {
+    Value *scope = tallocStatic(sizeof(Value));
+    scope -> type = SCOPE_TYPE;
+    scope -> sc.initialized = initialized;
+    scope -> sc.size = environment -> count;
+    scope -> sc.names = REF(staticList(environment -> names, environment -> count));
+    return scope;
+}
+
+// rebuild
+// params: head - the Values to put first, headCount - how many there are, rest - a list of expressions, environment - a pointer to an Environment
+// returns: a new static list of the head Values followed by each expression in rest, resolved in environment
+Value *rebuild(Value **head, size_t headCount, Value *rest, Environment *environment) {
+    size_t count = headCount + length(rest);
+    Value **items = malloc((count > 0 ? count : 1) * sizeof(Value *));
+    if (items == NULL) {
+        printf("Evaluation error: out of memory\n");
+        texit(0);
+    }
+    for (size_t i = 0; i < headCount; i++) {
+        items[i] = head[i];
+    }
+    for (size_t i = headCount; i < count; i++) {
+        items[i] = resolveExpression(car(rest), environment);
+        rest = cdr(rest);
+    }
+    Value *list = staticList(items, count);
+    free(items);
+    return list;
+}
+
+// validParameters
+// params: parameters - a pointer to a Value
+// returns: true if parameters is a list of distinct symbols
+bool validParameters(Value *parameters) {
+    for (Value *current = parameters; typeOf(current) != NULL_TYPE; current = cdr(current)) {
+        if (typeOf(current) != CONS_TYPE || typeOf(car(current)) != SYMBOL_TYPE) {
+            return false;
+        }
+        for (Value *earlier = parameters; earlier != current; earlier = cdr(earlier)) {
+            if (car(earlier) -> s == car(current) -> s) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// validBindings
+// params: bindings - a pointer to a Value
+// returns: true if bindings is a list of (name expression) lists whose names are distinct symbols; like the evaluator always
+// has, this ignores anything after a binding's expression
+bool validBindings(Value *bindings) {
+    for (Value *current = bindings; typeOf(current) != NULL_TYPE; current = cdr(current)) {
+        if (typeOf(current) != CONS_TYPE || typeOf(car(current)) != CONS_TYPE || length(car(current)) < 2
+            || typeOf(car(car(current))) != SYMBOL_TYPE) {
+            return false;
+        }
+        for (Value *earlier = bindings; earlier != current; earlier = cdr(earlier)) {
+            if (car(car(earlier)) -> s == car(car(current)) -> s) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// resolveFrame
+// params: form - a lambda, let or letrec form; environment - a pointer to the Environment it appears in
+// returns: the resolved form, or form itself if it isn't well-formed
+// lambda's parameters, or let's or letrec's names, come first in the new frame, then whatever the body defines
+Value *resolveFrame(Value *form, Environment *environment) {
+    Value *keyword = car(form);
+    Value *args = cdr(form);
+    bool isLambda = isKeyword(keyword, lambdaKeyword);
+    if (length(args) < 2 || (isLambda ? !validParameters(car(args)) : !validBindings(car(args)))) {
+        return tagForm(form);
+    }
+
+    Environment inner = {environment, NULL, 0, 0};
+    for (Value *current = car(args); typeOf(current) != NULL_TYPE; current = cdr(current)) {
+        addName(&inner, isLambda ? car(current) : car(car(current)));
+    }
+    uint32_t initialized = inner.count;
+    for (Value *body = cdr(args); typeOf(body) != NULL_TYPE; body = cdr(body)) {
+        addDefinitions(car(body), &inner);
+    }
+
+    Value *head[3] = {tagKeyword(keyword), makeScope(&inner, initialized), NULL};
+    size_t headCount = 2;
+    if (!isLambda) {
+        // a let's expressions are evaluated in the frame around it, a letrec's in its own
+        Environment *scope = isKeyword(keyword, letKeyword) ? environment : &inner;
+        Value **expressions = malloc((initialized > 0 ? initialized : 1) * sizeof(Value *));
+        if (expressions == NULL) {
+            printf("Evaluation error: out of memory\n");
+            texit(0);
+        }
+        Value *binding = car(args);
+        for (uint32_t i = 0; i < initialized; i++) {
+            expressions[i] = resolveExpression(car(cdr(car(binding))), scope);
+            binding = cdr(binding);
+        }
+        head[2] = staticList(expressions, initialized);
+        free(expressions);
+        headCount = 3;
+    }
+    Value *resolved = rebuild(head, headCount, cdr(args), &inner);
+    free(inner.names);
+    return resolved;
+}
+
+// resolveExpression
+// params: expression - a pointer to a Value from the parse tree; environment - a pointer to the Environment it appears in
+// returns: the resolved expression
+Value *resolveExpression(Value *expression, Environment *environment) {
+    if (typeOf(expression) == SYMBOL_TYPE) {
+        return makeReference(expression, environment);
+    } else if (typeOf(expression) != CONS_TYPE) {
+        return expression;
+    }
+
+    Value *first = car(expression);
+    Value *args = cdr(expression);
+    if (isKeyword(first, quoteKeyword) || isKeyword(first, recordKeyword)) {
+        return tagForm(expression);
+    } else if (isKeyword(first, lambdaKeyword) || isKeyword(first, letKeyword) || isKeyword(first, letrecKeyword)) {
+        return resolveFrame(expression, environment);
+    } else if (isKeyword(first, defineKeyword) || isKeyword(first, setKeyword)) {
+        if (length(args) != 2 || typeOf(car(args)) != SYMBOL_TYPE) {
+            return tagForm(expression);
+        }
+        // define always adds to the current frame, so only set!'s variable has to be looked up
+        Value *head[2] = {tagKeyword(first), isKeyword(first, setKeyword) ? makeReference(car(args), environment) : car(args)};
+        return rebuild(head, 2, cdr(args), environment);
+    } else if (typeOf(first) == SYMBOL_TYPE && specialForm(first -> s) != NULL) {
+        // any other special form, such as if or begin, has only expressions for arguments
+        Value *head = tagKeyword(first);
+        return rebuild(&head, 1, args, environment);
+    }
+    return rebuild(NULL, 0, expression, environment);
+}
+
+// resolve
+// params: form - a pointer to a top-level form from the parse tree
+// returns: the form with its variable references resolved (see resolver.h)
+Value *resolve(Value *form) {
+    if (quoteKeyword == NULL) {
+        quoteKeyword = intern("quote");
+        lambdaKeyword = intern("lambda");
+        letKeyword = intern("let");
+        letrecKeyword = intern("letrec");
+        defineKeyword = intern("define");
+        setKeyword = intern("set!");
+        recordKeyword = intern("define-record-type");
+    }
+    return resolveExpression(form, NULL);
+}
+
+#endif
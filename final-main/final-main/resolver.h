@@ -0,0 +1,30 @@
+#include "value.h"
+
+#ifndef _RESOLVER
+#define _RESOLVER
+
+// Return a copy of a top-level form from the parse tree in which every
+// variable reference has been worked out ahead of time. A reference to a
+// variable bound by an enclosing lambda, let or letrec (or defined in its
+// body) becomes a LOCAL_REF_TYPE value giving the variable's frame and slot,
+// and any other reference a GLOBAL_REF_TYPE value pointing at the variable's
+// cell in the global environment, which is made, unbound, if the variable
+// hasn't been defined yet. Until a body's define has run, a reference to the
+// variable it defines means whatever the name means outside the body, as if
+// the define weren't there. The keyword of each special form's combination
+// becomes the form's SPECIAL_FORM_TYPE value (see special.h), and each lambda,
+// let and letrec gets a SCOPE_TYPE value listing its frame's variables in slot
+// order, in place of its parameters, or ahead of its bindings' expressions:
+//
+//     (lambda scope body ...)
+//     (let scope (expression ...) body ...)
+//     (letrec scope (expression ...) body ...)
+//
+// The arguments of a special form that resolve doesn't know about are resolved
+// as expressions, like if's and begin's. Quoted data is left alone, as is any
+// form that isn't well-formed, so that evaluating it reports the same error it
+// always has. The copy is static (see tallocStatic), like the parse tree
+// itself.
+Value *resolve(Value *form);
+
+#endif
@@ -0,0 +1,58 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "value.h"
+#include "talloc.h"
+#include "symbol.h"
+
+#ifndef _SPECIAL
+#define _SPECIAL
+
+// One registered special form's SPECIAL_FORM_TYPE value, and the one
+// registered before it. There are only ever a handful, and they're only looked
+// up by name while resolving, so a list is all the table they need.
+typedef struct Registration {
+    Value *form;
+    struct Registration *next;
+} Registration;
+
+// define the most recently registered special form
+Registration *specialForms = NULL;
+
+// specialForm
+// params: name - an interned name
+// returns: the SPECIAL_FORM_TYPE value of the special form with that keyword, or NULL if there is none
+Value *specialForm(char *name) {
+    for (Registration *current = specialForms; current != NULL; current = current -> next) {
+        if (current -> form -> sf -> name == name) {
+            return current -> form;
+        }
+    }
+    return NULL;
+}
+
+// defineSpecialForm
+// params: name - the keyword; evaluate - the function that evaluates the special form's combinations
+// returns: Nothing
+// the registration is static (see tallocStatic), like the resolved code that points at it
+void defineSpecialForm(char *name, SpecialFormFunction evaluate) {
+    name = intern(name);
+    Value *form = specialForm(name);
+    if (form != NULL) {
+        form -> sf -> evaluate = evaluate;
+        return;
+    }
+    SpecialForm *special = tallocStatic(sizeof(SpecialForm));
+    special -> name = name;
+    special -> evaluate = evaluate;
+    form = tallocStatic(sizeof(Value));
+    form -> type = SPECIAL_FORM_TYPE;
+    form -> sf = special;
+    Registration *registration = tallocStatic(sizeof(Registration));
+    registration -> form = form;
+    registration -> next = specialForms;
+    specialForms = registration;
+}
+
+#endif
@@ -0,0 +1,21 @@
+#include "value.h"
+
+#ifndef _SPECIAL
+#define _SPECIAL
+
+// Special forms: keywords such as if and lambda whose combinations aren't
+// procedure calls. Each is registered once, with the function that evaluates
+// its combinations (see SpecialForm in value.h). The resolver replaces the
+// keyword at the head of each such combination with the form's
+// SPECIAL_FORM_TYPE value, so evaluating the combination is one call through
+// it, and an ordinary call never checks its operator against the keywords.
+
+// Register a special form under the given keyword, or replace the function of
+// the one already registered there.
+void defineSpecialForm(char *name, SpecialFormFunction evaluate);
+
+// Return the SPECIAL_FORM_TYPE value for the given interned name, or NULL if
+// no special form has that keyword.
+Value *specialForm(char *name);
+
+#endif
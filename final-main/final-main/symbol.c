@@ -0,0 +1,109 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "talloc.h"
+
+#ifndef _SYMBOL
+#define _SYMBOL
+
+// The intern table is an open-addressing hash table of names, kept at most
+// this full (in percent) so probe sequences stay short.
+#define MAX_LOAD 70
+
+// define the table of interned names (NULL for empty slots), its capacity (a power of two) and the number of names in
+// it, and whether freeSymbols has been registered to run at exit
+char **symbols = NULL;
+size_t symbolCapacity = 0;
+size_t symbolCount = 0;
+bool symbolsRegistered = false;
+
+// hashBytes
+// params: bytes - the bytes to hash
+//         length - how many there are
+// returns: their FNV-1a hash
+uint64_t hashBytes(const char *bytes, size_t length) {
+    uint64_t hash = 14695981039346656037u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)bytes[i];
+        hash *= 1099511628211u;
+    }
+    return hash;
+}
+
+// freeSymbols
+// params: None
+// returns: Nothing
+// frees every interned name and the table; registered with atexit so texit leaves nothing behind
+void freeSymbols() {
+    for (size_t i = 0; i < symbolCapacity; i++) {
+        free(symbols[i]);
+    }
+    free(symbols);
+    symbols = NULL;
+    symbolCapacity = 0;
+    symbolCount = 0;
+}
+
+// allocOrDie
+// params: size - a number of bytes
+// returns: a pointer to size zeroed bytes from calloc
+// exits the program if the system is out of memory
+void *allocOrDie(size_t size) {
+    void *memory = calloc(1, size);
+    if (memory == NULL) {
+        printf("Error: out of memory\n");
+        texit(1);
+    }
+    return memory;
+}
+
+// growSymbols
+// params: None
+// returns: Nothing
+// doubles the table's capacity, rehashing every name into the new table
+void growSymbols() {
+    size_t newCapacity = symbolCapacity == 0 ? 256 : symbolCapacity * 2;
+    char **grown = allocOrDie(newCapacity * sizeof(char *));
+    for (size_t i = 0; i < symbolCapacity; i++) {
+        if (symbols[i] != NULL) {
+            size_t slot = hashBytes(symbols[i], strlen(symbols[i])) & (newCapacity - 1);
+            while (grown[slot] != NULL) {
+                slot = (slot + 1) & (newCapacity - 1);
+            }
+            grown[slot] = symbols[i];
+        }
+    }
+    free(symbols);
+    symbols = grown;
+    symbolCapacity = newCapacity;
+    if (!symbolsRegistered) {
+        atexit(freeSymbols);
+        symbolsRegistered = true;
+    }
+}
+
+// intern
+// params: name - a symbol's name
+// returns: the interned copy of the name; the same pointer for every name with the same characters
+char *intern(const char *name) {
+    if ((symbolCount + 1) * 100 > symbolCapacity * MAX_LOAD) {
+        growSymbols();
+    }
+    size_t slot = hashBytes(name, strlen(name)) & (symbolCapacity - 1);
+    while (symbols[slot] != NULL) {
+        if (!strcmp(symbols[slot], name)) {
+            return symbols[slot];
+        }
+        slot = (slot + 1) & (symbolCapacity - 1);
+    }
+    size_t length = strlen(name);
+    char *copy = allocOrDie(length + 1);
+    memcpy(copy, name, length + 1);
+    symbols[slot] = copy;
+    symbolCount++;
+    return copy;
+}
+
+#endif
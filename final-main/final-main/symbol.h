@@ -0,0 +1,17 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef _SYMBOL
+#define _SYMBOL
+
+// Return the one copy of the given symbol name, making it on first use. Every
+// SYMBOL_TYPE Value's name comes from here, so two symbols are the same symbol
+// exactly when their names are the same pointer, and comparing them never
+// needs strcmp. Interned names are never freed until the program exits.
+char *intern(const char *name);
+
+// Return the FNV-1a hash of length bytes, which the symbol table and strings'
+// cached hashes both use.
+uint64_t hashBytes(const char *bytes, size_t length);
+
+#endif
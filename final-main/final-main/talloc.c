@@ -1,91 +1,1888 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
 #include "value.h"
 #include <assert.h>
 
 #ifndef _TALLOC
 #define _TALLOC
 
-// define global list to hold pointers to allocated memory
-Value *memoryAddresses = NULL;
+// Number of bytes in each arena chunk; an ordinary chunk is one heap block
+// (see SLAB_SIZE). Requests larger than LARGE_REQUEST get a chunk of their own,
+// malloc'd to size, so they don't waste the tail of the current one.
+#define CHUNK_SIZE (64 * 1024)
+#define LARGE_REQUEST (CHUNK_SIZE / 4)
+
+// Every pointer handed out by talloc is a multiple of this, which is enough for
+// any type we store (doubles, pointers, Values, Frames).
+#define ALIGNMENT 16
+
+// Slabs, nursery blocks and ordinary arena chunks are all SLAB_SIZE blocks
+// aligned to SLAB_SIZE, and all start with their kind, so masking an object's
+// address tells which of the three it lives in.
+typedef enum {
+    SLAB_BLOCK, NURSERY_BLOCK, ARENA_BLOCK
+} BlockKind;
+
+// A chunk is one malloc'd block that talloc carves allocations out of by
+// bumping a pointer. Chunks are kept in a linked list so tfree can release
+// everything in one pass over the chunks rather than one pass per allocation.
+typedef struct Chunk {
+    BlockKind kind; // always ARENA_BLOCK
+    struct Chunk *next;
+    char *bump;     // next free byte in this chunk
+    char *limit;    // one past the last usable byte in this chunk
+    size_t large;   // for a malloc'd chunk, its size in bytes; 0 for a chunk that is a heap block
+} Chunk;
+
+// Values and Frames make up almost every allocation, so they get their own
+// fixed-size pools instead of sharing the arena with strings. Each pool is a
+// list of slabs; a slab is SLAB_SIZE bytes aligned to SLAB_SIZE, so the slab
+// owning any object can be found by masking its address. Objects start on a
+// cache line boundary and are packed back to back.
+#define SLAB_SIZE (64 * 1024)
+#define CACHE_LINE 64
+
+// Frames are as big as their slot arrays, so they come in size classes, each
+// with a pool of its own: every multiple of FRAME_STEP bytes up to SMALL_FRAME,
+// then every power of two up to LARGE_FRAME, the biggest frame there is.
+#define FRAME_STEP 8
+#define SMALL_FRAME 256
+#define LARGE_FRAME 8192
+#define SMALL_CLASSES (SMALL_FRAME / FRAME_STEP)
+#define FRAME_CLASSES (SMALL_CLASSES + 5)
+
+// Each slab carries one mark bit per slot for the garbage collector, enough
+// for objects as small as 8 bytes, and a second bit per slot recording whether
+// the object is in the collector's remembered set.
+#define MARK_WORDS (SLAB_SIZE / 8 / 64)
+
+typedef struct Slab {
+    BlockKind kind;           // always SLAB_BLOCK
+    struct Slab *next;        // next slab in the pool's list of all slabs
+    struct Slab *nextPartial; // next slab in the pool's list of slabs with released slots
+    struct Pool *pool;        // the pool this slab belongs to
+    void *freeList;           // slots handed back with trelease or by a sweep, linked through their first word
+    char *start;              // first slot
+    char *bump;               // next never-used slot
+    char *limit;              // one past the last slot that fits in the slab
+    bool partial;             // whether this slab is on the pool's partial list
+    bool detached;            // whether this slab has been taken out of its pool to be swept
+    size_t live;              // number of marked slots the last sweep of this slab found
+    uint64_t marks[MARK_WORDS];
+    uint64_t remembered[MARK_WORDS];
+} Slab;
+
+typedef struct Pool {
+    size_t objectSize;
+    Slab *slabs;       // every slab in the pool
+    Slab *current;     // slab allocations are currently served from
+    Slab *partial;     // slabs other than current that have released slots
+    size_t inUse;      // bytes handed out and not yet released or swept
+    void *owner;       // the thread that allocates from this pool (see threadId)
+} Pool;
+
+// Each thread allocates from contexts of its own, so the pools, the nursery
+// and the arena chunks a thread bumps through act as its private allocation
+// buffers and need no locking. Only refills touch shared state: slabs and
+// nursery blocks come from a shared pool of free SLAB_SIZE blocks, which each
+// thread takes from and gives back to BLOCK_BATCH blocks at a time through a
+// small cache of its own, so the lock is taken about once per half megabyte.
+// The garbage collector only ever marks and sweeps the calling thread's pools.
+#define BLOCK_BATCH 8
+#define SPARE_LIMIT (2 * BLOCK_BATCH)
+#define SHARED_LIMIT 256
+
+// define the shared pool of free blocks, linked through their first word, and the lock that protects it
+void *sharedBlocks = NULL;
+size_t sharedCount = 0;
+pthread_mutex_t blockLock = PTHREAD_MUTEX_INITIALIZER;
+
+// The blocks themselves are carved out of one region of address space that is
+// reserved with mmap up front and made usable HEAP_GROW bytes at a time, so
+// the heap stays contiguous and can be backed by transparent hugepages. Free
+// blocks beyond what the shared pool keeps are handed back to the system with
+// madvise(MADV_DONTNEED), which releases their memory but keeps their address
+// range for reuse. If SCHEME_HEAP_LIMIT is set, the heap may not hold more than
+// that many bytes; going over it is a Scheme "out of memory" error. If the
+// region can't be reserved at all, blocks come from posix_memalign instead,
+// except in a COMPRESSED_REFS build (see value.h), where every Value and Frame
+// has to be addressable by a 32-bit offset from the start of the region. The
+// region's first HEAP_GROW bytes are never used, so small offsets are left
+// free for immediates.
+#ifdef COMPRESSED_REFS
+#define HEAP_RESERVE (((size_t)1 << (32 + REF_SHIFT)) - HEAP_GROW)
+#else
+#define HEAP_RESERVE ((size_t)64 << 30)
+#endif
+#define HEAP_GROW (2 * 1024 * 1024)
+
+// define the heap region (heapStart is NULL if there is none), the end of the part blocks have been carved from, the
+// end of the part that is readable and writable, and the end of the reservation
+char *heapStart = NULL;
+char *heapTop = NULL;
+char *heapUsable = NULL;
+char *heapEnd = NULL;
+pthread_once_t heapOnce = PTHREAD_ONCE_INIT;
+
+// define the blocks whose memory has been given back to the system, by index into the region; they aren't linked
+// through their first word, since writing to one would bring its memory back
+uint32_t *cleanBlocks = NULL;
+size_t cleanCount = 0;
+size_t cleanCapacity = 0;
+
+// define the heap's limit in bytes (0 for none), whether to ask for hugepages, how many bytes of memory the heap is
+// holding on to (all under blockLock), how many of those are handed out rather than sitting in a cache, and how many
+// may be handed out before the garbage collector should run early to stay under the limit
+size_t heapLimit = 0;
+bool hugePages = false;
+size_t heapCommitted = 0;
+atomic_size_t heapInUse = 0;
+atomic_size_t pressureMark = 0;
+
+// define this thread's cache of free blocks, and the key whose destructor hands it back when the thread exits
+_Thread_local void *spareBlocks = NULL;
+_Thread_local size_t spareCount = 0;
+pthread_key_t spareKey;
+pthread_once_t spareKeyOnce = PTHREAD_ONCE_INIT;
+
+// define this thread's identity, which is just the address of a thread-local byte
+_Thread_local char threadTag;
+
+// define the total number of bytes in use across this thread's pools, which the garbage collector uses to decide
+// when to run
+_Thread_local size_t pooledBytes = 0;
+
+// A sweep takes every slab out of its pool and queues it on sweepQueue. Slabs
+// are swept one at a time, either by whoever calls tallocSweepStep or by a
+// background sweeper thread, and come back through sweptQueue to be put back
+// in their pools. Only the queues and sweeperStopping are shared with the
+// sweeper thread, always under sweepLock; a slab in flight belongs to the
+// sweeper, and nothing else touches its free list or mark bits until it has
+// been handed back.
+Slab *sweepQueue = NULL;
+Slab *sweptQueue = NULL;
+size_t sweepOutstanding = 0;
+bool sweeperRunning = false;
+bool sweeperStopping = false;
+pthread_t sweeper;
+pthread_mutex_t sweepLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t sweepWork = PTHREAD_COND_INITIALIZER;
+pthread_cond_t sweepDone = PTHREAD_COND_INITIALIZER;
+
+// While the garbage collector is running, new Values and Frames are bump
+// allocated in the nursery instead of the pools, and the survivors are copied
+// into the root context's pools by the next minor collection. A nursery block
+// has one bit per 16 bytes recording which objects have already been copied;
+// a copied object's first word then holds its new address.
+typedef struct NurseryBlock {
+    BlockKind kind;                 // always NURSERY_BLOCK
+    struct NurseryBlock *next;
+    char *start;                    // first object
+    char *bump;                     // next free byte
+    char *limit;                    // one past the last usable byte
+    uint64_t forwarded[SLAB_SIZE / ALIGNMENT / 64];
+} NurseryBlock;
+
+// define this thread's nursery blocks (the head is the one being bumped), how many bytes it should hold before a
+// minor collection is due (0 when there is no nursery), and how many bytes have been allocated in it since the last
+// one
+_Thread_local NurseryBlock *nurseryBlocks = NULL;
+_Thread_local NurseryBlock *nurseryCurrent = NULL;
+_Thread_local size_t nurseryTarget = 0;
+_Thread_local size_t nurseryAllocated = 0;
+
+// A context owns a set of chunks and pools, plus any child contexts created
+// inside it. Freeing a context frees its whole subtree at once, so memory that
+// is only needed for one phase (tokenizing, one top-level form) can be dropped
+// without waiting for tfree.
+struct TallocContext {
+    struct TallocContext *parent;
+    struct TallocContext *children;     // first child; the rest hang off nextSibling
+    struct TallocContext *nextSibling;
+    Chunk *chunks;                      // the head is the chunk currently being bumped
+    Pool valuePool;
+    Pool framePools[FRAME_CLASSES];     // by size class (see frameClassSize)
+    struct Payload *payloads;           // payloads of the Values in the context's pools and arena
+};
+
+typedef struct TallocContext TallocContext;
+
+// A payload is malloc'd through bigAlloc, so it counts against the heap limit,
+// with this header in front of it. Payloads are kept on doubly linked lists so
+// that any one of them can be freed on its own: those whose owners are in the
+// nursery on a list of the thread's own, which every minor collection goes
+// through, and the rest on the list of the context they belong to, which every
+// full collection goes through before it sweeps.
+typedef struct Payload {
+    struct Payload *next;
+    struct Payload **link;  // the pointer to this payload: the previous payload's next, or the list's head
+    void *owner;            // the Value the payload belongs to
+    size_t size;            // the size passed to bigAlloc, header included
+    void (*cleanup)(void *memory);  // called on the payload just before it is freed, or NULL
+} Payload;
+
+// define this thread's list of payloads whose owners are in the nursery, and the number of bytes held by the
+// payloads on its contexts' lists, which count towards pooledBytes
+_Thread_local Payload *youngPayloads = NULL;
+_Thread_local size_t payloadBytes = 0;
+
+// Allocation profiling counts objects and bytes per calling function, keyed by
+// the address of the caller's __func__ string in an open-addressing table.
+// Profiling is off until the first allocation finds SCHEME_TALLOC_PROFILE set.
+typedef struct AllocSite {
+    const char *name;
+    size_t objects;
+    size_t bytes;
+} AllocSite;
+
+// define the profile table, its capacity (a power of two) and its number of sites, whether profiling is on (checked
+// once, by the first allocation), and the lock that lets several threads share the table
+AllocSite *sites = NULL;
+size_t siteCapacity = 0;
+size_t siteCount = 0;
+bool profiling = false;
+pthread_once_t profilingChecked = PTHREAD_ONCE_INIT;
+pthread_mutex_t profileLock = PTHREAD_MUTEX_INITIALIZER;
+
+// define the root context, which lives until tfree and belongs to the first thread to allocate, and the lock held
+// while contexts are added to or removed from the tree
+TallocContext rootContext = {.valuePool = {.objectSize = sizeof(Value)}};
+bool rootClaimed = false;
+pthread_mutex_t contextLock = PTHREAD_MUTEX_INITIALIZER;
+
+// define the context this thread allocates from when it hasn't switched anywhere else (NULL until its first
+// allocation), and the context it currently allocates from
+_Thread_local TallocContext *homeContext = NULL;
+_Thread_local TallocContext *currentContext = NULL;
+
+TallocContext *tcontextNew(TallocContext *parent);
+
+// frameClassSize
+// params: index - a frame size class, less than FRAME_CLASSES
+// returns: the size of the objects in that class's pools
+size_t frameClassSize(int index) {
+    if (index < SMALL_CLASSES) {
+        return (size_t)(index + 1) * FRAME_STEP;
+    }
+    return (size_t)SMALL_FRAME << (index - SMALL_CLASSES + 1);
+}
+
+// initPools
+// params: context - a pointer to a TallocContext; owner - the thread that allocates from it
+// returns: Nothing
+// gives the context an empty Value pool and an empty Frame pool for each size class
+void initPools(TallocContext *context, void *owner) {
+    context -> valuePool = (Pool){sizeof(Value), NULL, NULL, NULL, 0, owner};
+    for (int index = 0; index < FRAME_CLASSES; index++) {
+        context -> framePools[index] = (Pool){frameClassSize(index), NULL, NULL, NULL, 0, owner};
+    }
+}
+
+// threadId
+// params: None
+// returns: a pointer that is different for every running thread
+void *threadId() {
+    return &threadTag;
+}
+
+// activeContext
+// params: None
+// returns: a pointer to the TallocContext this thread allocates from
+// the first thread to allocate gets the root context as its home; every other thread gets a new context under it
+TallocContext *activeContext() {
+    if (currentContext != NULL) {
+        return currentContext;
+    }
+    if (homeContext == NULL) {
+        pthread_mutex_lock(&contextLock);
+        if (!rootClaimed) {
+            rootClaimed = true;
+            initPools(&rootContext, threadId());
+            homeContext = &rootContext;
+        }
+        pthread_mutex_unlock(&contextLock);
+        if (homeContext == NULL) {
+            homeContext = tcontextNew(NULL);
+        }
+    }
+    currentContext = homeContext;
+    return currentContext;
+}
+
+// tallocParseSize
+// params: text - a string such as "4096", "512k" or "64m"
+// returns: the number of bytes it names
+size_t tallocParseSize(const char *text) {
+    char *end;
+    double amount = strtod(text, &end);
+    switch (*end) {
+        case 'g':
+        case 'G':
+            amount *= 1024;
+            // fall through
+        case 'm':
+        case 'M':
+            amount *= 1024;
+            // fall through
+        case 'k':
+        case 'K':
+            amount *= 1024;
+            break;
+        default:
+            break;
+    }
+    return amount < 0 ? 0 : (size_t)amount;
+}
+
+// initHeap
+// params: None
+// returns: Nothing
+// reads SCHEME_HEAP_LIMIT and SCHEME_HEAP_HUGEPAGES and reserves the heap region, aligned to HEAP_GROW; asks for a
+// smaller region if the system won't reserve the full size, and for none at all if even that fails
+void initHeap() {
+    char *limit = getenv("SCHEME_HEAP_LIMIT");
+    heapLimit = limit != NULL ? tallocParseSize(limit) : 0;
+    char *huge = getenv("SCHEME_HEAP_HUGEPAGES");
+    hugePages = huge != NULL && strcmp(huge, "0") != 0;
+    atomic_store(&pressureMark, heapLimit / 2);
+
+    size_t reserve = HEAP_RESERVE;
+    if (heapLimit > 0 && heapLimit < reserve) {
+        reserve = (heapLimit + HEAP_GROW - 1) & ~(size_t)(HEAP_GROW - 1);
+    }
+    while (reserve >= HEAP_GROW) {
+        void *region = mmap(NULL, reserve + 2 * HEAP_GROW, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (region != MAP_FAILED) {
+            heapStart = (char *)(((uintptr_t)region + HEAP_GROW - 1) & ~(uintptr_t)(HEAP_GROW - 1));
+            heapTop = heapStart + HEAP_GROW;
+            heapUsable = heapTop;
+            heapEnd = heapTop + reserve;
+            return;
+        }
+        reserve /= 2;
+    }
+}
+
+// newBlock
+// params: None
+// returns: a pointer to SLAB_SIZE bytes aligned to SLAB_SIZE that the heap didn't have cached, or NULL if taking it
+// would go over the heap limit or the system has no more memory to give
+// the caller must hold blockLock; blocks released earlier are reused before the region grows
+void *newBlock() {
+    if (heapLimit > 0 && heapCommitted + SLAB_SIZE > heapLimit) {
+        return NULL;
+    }
+    void *block = NULL;
+    if (cleanCount > 0) {
+        cleanCount--;
+        block = heapStart + (size_t)cleanBlocks[cleanCount] * SLAB_SIZE;
+    } else if (heapStart != NULL) {
+        if (heapTop == heapEnd) {
+            return NULL;
+        }
+        if (heapTop == heapUsable) {
+            if (mprotect(heapUsable, HEAP_GROW, PROT_READ | PROT_WRITE) != 0) {
+                return NULL;
+            }
+            if (hugePages) {
+                madvise(heapUsable, HEAP_GROW, MADV_HUGEPAGE);
+            }
+            heapUsable += HEAP_GROW;
+        }
+        block = heapTop;
+        heapTop += SLAB_SIZE;
+    } else {
+#ifdef COMPRESSED_REFS
+        return NULL;
+#else
+        if (posix_memalign(&block, SLAB_SIZE, SLAB_SIZE) != 0) {
+            return NULL;
+        }
+#endif
+    }
+    heapCommitted += SLAB_SIZE;
+    return block;
+}
+
+// dropBlock
+// params: block - a pointer to a free block
+// returns: Nothing
+// gives the block's memory back to the system; the caller must hold blockLock
+void dropBlock(void *block) {
+    heapCommitted -= SLAB_SIZE;
+    if (heapStart == NULL) {
+        free(block);
+        return;
+    }
+    if (cleanCount == cleanCapacity) {
+        size_t capacity = cleanCapacity == 0 ? 256 : cleanCapacity * 2;
+        uint32_t *grown = realloc(cleanBlocks, capacity * sizeof(uint32_t));
+        if (grown == NULL) {
+            // the memory still goes back; only the address range is lost
+            madvise(block, SLAB_SIZE, MADV_DONTNEED);
+            return;
+        }
+        cleanBlocks = grown;
+        cleanCapacity = capacity;
+    }
+    madvise(block, SLAB_SIZE, MADV_DONTNEED);
+    cleanBlocks[cleanCount++] = (uint32_t)(((char *)block - heapStart) / SLAB_SIZE);
+}
+
+// shareBlock
+// params: block - a pointer to a free block
+// returns: Nothing
+// puts the block in the shared pool, or gives it back to the system if the pool is full; the caller must hold
+// blockLock
+void shareBlock(void *block) {
+    if (sharedCount < SHARED_LIMIT) {
+        *(void **)block = sharedBlocks;
+        sharedBlocks = block;
+        sharedCount++;
+    } else {
+        dropBlock(block);
+    }
+}
+
+void texit(int status);
+
+// outOfMemory
+// params: None
+// returns: Nothing
+// reports that the heap is full as a Scheme error and exits, the same way evaluation errors do
+void outOfMemory() {
+    printf("Evaluation error: out of memory\n");
+    texit(0);
+}
+
+// tallocHeapPressure
+// params: None
+// returns: true if a heap limit is set and enough of what is left under it has been used up that the garbage
+// collector should run now rather than wait for its usual threshold
+bool tallocHeapPressure() {
+    return heapLimit > 0 && atomic_load_explicit(&heapInUse, memory_order_relaxed) >= atomic_load_explicit(&pressureMark, memory_order_relaxed);
+}
+
+// giveBackSpares
+// params: unused - ignored
+// returns: Nothing
+// moves this thread's cache of free blocks to the shared pool, giving back to the system whatever the shared pool has
+// no room for; runs when a thread that has allocated exits
+void giveBackSpares(void *unused) {
+    (void)unused;
+    pthread_mutex_lock(&blockLock);
+    while (spareBlocks != NULL) {
+        void *block = spareBlocks;
+        spareBlocks = *(void **)block;
+        shareBlock(block);
+    }
+    spareCount = 0;
+    pthread_mutex_unlock(&blockLock);
+}
+
+// makeSpareKey
+// params: None
+// returns: Nothing
+void makeSpareKey() {
+    pthread_key_create(&spareKey, giveBackSpares);
+}
+
+// takeBlock
+// params: None
+// returns: a pointer to SLAB_SIZE bytes aligned to SLAB_SIZE
+// takes a block from this thread's cache, refilling the cache from the shared pool a batch at a time, and only grows
+// the heap when both are empty; a full heap is reported as a Scheme out of memory error
+void *takeBlock() {
+    if (spareBlocks == NULL) {
+        pthread_once(&heapOnce, initHeap);
+        pthread_once(&spareKeyOnce, makeSpareKey);
+        pthread_setspecific(spareKey, &threadTag);
+        pthread_mutex_lock(&blockLock);
+        while (sharedBlocks != NULL && spareCount < BLOCK_BATCH) {
+            void *block = sharedBlocks;
+            sharedBlocks = *(void **)block;
+            sharedCount--;
+            *(void **)block = spareBlocks;
+            spareBlocks = block;
+            spareCount++;
+        }
+        if (spareBlocks == NULL) {
+            void *block = newBlock();
+            pthread_mutex_unlock(&blockLock);
+            if (block == NULL) {
+                outOfMemory();
+            }
+            atomic_fetch_add_explicit(&heapInUse, SLAB_SIZE, memory_order_relaxed);
+            return block;
+        }
+        pthread_mutex_unlock(&blockLock);
+    }
+    void *block = spareBlocks;
+    spareBlocks = *(void **)block;
+    spareCount--;
+    atomic_fetch_add_explicit(&heapInUse, SLAB_SIZE, memory_order_relaxed);
+    return block;
+}
+
+// giveBlock
+// params: block - a pointer to a block returned by takeBlock
+// returns: Nothing
+// puts the block in this thread's cache; when the cache gets too big, a batch goes back to the shared pool, and
+// blocks the shared pool has no room for go back to the system
+void giveBlock(void *block) {
+    atomic_fetch_sub_explicit(&heapInUse, SLAB_SIZE, memory_order_relaxed);
+    *(void **)block = spareBlocks;
+    spareBlocks = block;
+    spareCount++;
+    if (spareCount <= SPARE_LIMIT) {
+        return;
+    }
+    pthread_mutex_lock(&blockLock);
+    while (spareCount > BLOCK_BATCH) {
+        block = spareBlocks;
+        spareBlocks = *(void **)block;
+        spareCount--;
+        shareBlock(block);
+    }
+    pthread_mutex_unlock(&blockLock);
+}
+
+// releaseBlocks
+// params: None
+// returns: Nothing
+// gives the memory of this thread's cache and of the whole shared pool back to the system
+void releaseBlocks() {
+    pthread_mutex_lock(&blockLock);
+    while (spareBlocks != NULL) {
+        void *next = *(void **)spareBlocks;
+        dropBlock(spareBlocks);
+        spareBlocks = next;
+    }
+    spareCount = 0;
+    while (sharedBlocks != NULL) {
+        void *next = *(void **)sharedBlocks;
+        dropBlock(sharedBlocks);
+        sharedBlocks = next;
+    }
+    sharedCount = 0;
+    pthread_mutex_unlock(&blockLock);
+}
+
+// bigAlloc
+// params: size - a number of bytes
+// returns: a pointer to size bytes from malloc, counted against the heap limit
+// a full heap is reported as a Scheme out of memory error
+void *bigAlloc(size_t size) {
+    pthread_once(&heapOnce, initHeap);
+    pthread_mutex_lock(&blockLock);
+    bool fits = heapLimit == 0 || heapCommitted + size <= heapLimit;
+    if (fits) {
+        heapCommitted += size;
+    }
+    pthread_mutex_unlock(&blockLock);
+    void *memory = fits ? malloc(size) : NULL;
+    if (memory == NULL) {
+        if (fits) {
+            pthread_mutex_lock(&blockLock);
+            heapCommitted -= size;
+            pthread_mutex_unlock(&blockLock);
+        }
+        outOfMemory();
+    }
+    atomic_fetch_add_explicit(&heapInUse, size, memory_order_relaxed);
+    return memory;
+}
+
+// bigFree
+// params: memory - a pointer returned by bigAlloc; size - the size it was allocated with
+// returns: Nothing
+void bigFree(void *memory, size_t size) {
+    atomic_fetch_sub_explicit(&heapInUse, size, memory_order_relaxed);
+    pthread_mutex_lock(&blockLock);
+    heapCommitted -= size;
+    pthread_mutex_unlock(&blockLock);
+    free(memory);
+}
+
+// alignUp
+// params: size - a number of bytes
+// returns: size rounded up to the next multiple of ALIGNMENT
+size_t alignUp(size_t size) {
+    return (size + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+}
+
+// newChunk
+// params: size - the number of usable bytes the chunk must hold, or 0 for an ordinary chunk
+// returns: a pointer to a new Chunk whose bump pointer is at its first aligned byte
+// an ordinary chunk is one heap block; a chunk for a large request is malloc'd to fit
+Chunk *newChunk(size_t size) {
+    size_t header = alignUp(sizeof(Chunk));
+    Chunk *chunk;
+    if (size == 0) {
+        chunk = takeBlock();
+        chunk -> kind = ARENA_BLOCK;
+        chunk -> large = 0;
+        size = CHUNK_SIZE - header;
+    } else {
+        chunk = bigAlloc(header + size);
+        chunk -> kind = ARENA_BLOCK;
+        chunk -> large = header + size;
+    }
+    chunk -> next = NULL;
+    chunk -> bump = (char *)chunk + header;
+    chunk -> limit = chunk -> bump + size;
+    return chunk;
+}
+
+// newSlab
+// params: pool - a pointer to the Pool the slab will belong to
+// returns: a pointer to a new, empty Slab which has been made the pool's current slab
+// exits the program if the system is out of memory
+Slab *newSlab(Pool *pool) {
+    Slab *slab = takeBlock();
+    size_t header = (sizeof(Slab) + CACHE_LINE - 1) & ~(size_t)(CACHE_LINE - 1);
+    size_t count = (SLAB_SIZE - header) / pool -> objectSize;
+    slab -> kind = SLAB_BLOCK;
+    slab -> pool = pool;
+    slab -> freeList = NULL;
+    slab -> start = (char *)slab + header;
+    slab -> bump = slab -> start;
+    slab -> limit = slab -> bump + count * pool -> objectSize;
+    memset(slab -> marks, 0, sizeof(slab -> marks));
+    memset(slab -> remembered, 0, sizeof(slab -> remembered));
+    slab -> partial = false;
+    slab -> detached = false;
+    slab -> live = 0;
+    slab -> nextPartial = NULL;
+    slab -> next = pool -> slabs;
+    pool -> slabs = slab;
+    pool -> current = slab;
+    return slab;
+}
+
+// poolAlloc
+// params: pool - a pointer to a Pool
+// returns: a pointer to a free slot of the pool's object size
+// reuses released slots from the current slab first, then bumps through its unused space, then moves on to a
+// slab with released slots, and only creates a new slab when nothing else is free
+void *poolAlloc(Pool *pool) {
+    pool -> inUse += pool -> objectSize;
+    pooledBytes += pool -> objectSize;
+
+    Slab *slab = pool -> current;
+    while (true) {
+        if (slab != NULL) {
+            if (slab -> freeList != NULL) {
+                void *slot = slab -> freeList;
+                slab -> freeList = *(void **)slot;
+                return slot;
+            }
+            if (slab -> bump < slab -> limit) {
+                void *slot = slab -> bump;
+                slab -> bump += pool -> objectSize;
+                return slot;
+            }
+        }
+
+        // current slab is full; take the next slab that has released slots
+        slab = pool -> partial;
+        if (slab == NULL) {
+            break;
+        }
+        pool -> partial = slab -> nextPartial;
+        slab -> partial = false;
+        pool -> current = slab;
+    }
+
+    slab = newSlab(pool);
+    void *slot = slab -> bump;
+    slab -> bump += pool -> objectSize;
+    return slot;
+}
+
+// slabOf
+// params: object - a pointer to a Value or Frame allocated from a pool
+// returns: a pointer to the Slab the object lives in
+Slab *slabOf(void *object) {
+    return (Slab *)((uintptr_t)object & ~(uintptr_t)(SLAB_SIZE - 1));
+}
+
+// tallocIsStatic
+// params: object - a pointer to a Value
+// returns: true if the object was allocated by tallocStatic rather than from the nursery or a pool
+bool tallocIsStatic(void *object) {
+    return *(BlockKind *)slabOf(object) == ARENA_BLOCK;
+}
+
+// tallocIsYoung
+// params: object - a pointer to a Value or Frame
+// returns: true if the object is in the nursery, false if it is in a pool
+bool tallocIsYoung(void *object) {
+    return *(BlockKind *)slabOf(object) == NURSERY_BLOCK;
+}
+
+// poolFor
+// params: context - a pointer to a TallocContext; size - a number of bytes
+// returns: the context's Pool serving allocations of exactly that size, or NULL if the size goes to the general arena
+Pool *poolFor(TallocContext *context, size_t size) {
+    if (size == sizeof(Value)) {
+        return &context -> valuePool;
+    }
+    return NULL;
+}
+
+// framePoolFor
+// params: context - a pointer to a TallocContext; size - the size of a Frame in bytes, at most LARGE_FRAME
+// returns: the context's Pool for the smallest size class that fits the frame
+Pool *framePoolFor(TallocContext *context, size_t size) {
+    if (size <= SMALL_FRAME) {
+        return &context -> framePools[(size + FRAME_STEP - 1) / FRAME_STEP - 1];
+    }
+    int index = SMALL_CLASSES;
+    while (frameClassSize(index) < size) {
+        index++;
+    }
+    return &context -> framePools[index];
+}
+
+// freePool
+// params: pool - a pointer to a Pool
+// returns: Nothing
+// releases every slab in the pool and resets it to empty
+void freePool(Pool *pool) {
+    if (pool -> owner == threadId()) {
+        pooledBytes -= pool -> inUse;
+    }
+    pool -> inUse = 0;
+    Slab *current = pool -> slabs;
+    while (current != NULL) {
+        Slab *next = current -> next;
+        giveBlock(current);
+        current = next;
+    }
+    pool -> slabs = NULL;
+    pool -> current = NULL;
+    pool -> partial = NULL;
+}
+
+// freeChunks
+// params: chunk - the first Chunk in a list of chunks
+// returns: Nothing
+// releases every chunk in the list
+void freeChunks(Chunk *chunk) {
+    while (chunk != NULL) {
+        Chunk *next = chunk -> next;
+        if (chunk -> large > 0) {
+            bigFree(chunk, chunk -> large);
+        } else {
+            giveBlock(chunk);
+        }
+        chunk = next;
+    }
+}
+
+// arenaAlloc
+// params: context - a pointer to a TallocContext; size - the number of bytes requested to allocate
+// returns: a pointer to the allocated block
+// hands out memory by bumping a pointer through the context's current chunk
+// when the current chunk is full a new one is pushed onto the context's chunk list
+// large requests get a dedicated chunk, linked in behind the current one so the current chunk keeps being used
+void *arenaAlloc(TallocContext *context, size_t size) {
+    size = alignUp(size);
+    Chunk *chunks = context -> chunks;
+
+    // fast path: room left in the current chunk
+    if (chunks != NULL && size <= (size_t)(chunks -> limit - chunks -> bump)) {
+        void *block = chunks -> bump;
+        chunks -> bump += size;
+        return block;
+    }
+
+    if (size > LARGE_REQUEST) {
+        Chunk *large = newChunk(size);
+        if (chunks == NULL) {
+            context -> chunks = large;
+        } else {
+            large -> next = chunks -> next;
+            chunks -> next = large;
+        }
+        large -> bump = large -> limit;
+        return large -> limit - size;
+    }
+
+    Chunk *chunk = newChunk(0);
+    chunk -> next = chunks;
+    context -> chunks = chunk;
+
+    void *block = chunk -> bump;
+    chunk -> bump += size;
+    return block;
+}
+
+// newNurseryBlock
+// params: None
+// returns: a pointer to a new, empty NurseryBlock, linked in after the current one
+// exits the program if the system is out of memory
+NurseryBlock *newNurseryBlock() {
+    NurseryBlock *block = takeBlock();
+    block -> kind = NURSERY_BLOCK;
+    block -> start = (char *)block + alignUp(sizeof(NurseryBlock));
+    block -> bump = block -> start;
+    block -> limit = (char *)block + SLAB_SIZE;
+    memset(block -> forwarded, 0, sizeof(block -> forwarded));
+    if (nurseryCurrent == NULL) {
+        block -> next = nurseryBlocks;
+        nurseryBlocks = block;
+    } else {
+        block -> next = nurseryCurrent -> next;
+        nurseryCurrent -> next = block;
+    }
+    return block;
+}
+
+// nurseryAlloc
+// params: size - the number of bytes requested to allocate
+// returns: a pointer to the allocated block
+// bumps through the current nursery block, moving on to the next one (or a new one) when it is full; the nursery
+// is allowed to grow past its target, since allocation can't wait for the collector's next safe point
+void *nurseryAlloc(size_t size) {
+    size = alignUp(size);
+    nurseryAllocated += size;
+    NurseryBlock *block = nurseryCurrent;
+    if (block == NULL || size > (size_t)(block -> limit - block -> bump)) {
+        if (block != NULL && block -> next != NULL) {
+            block = block -> next;
+        } else {
+            block = newNurseryBlock();
+        }
+        nurseryCurrent = block;
+    }
+    void *object = block -> bump;
+    block -> bump += size;
+    return object;
+}
+
+// siteSlot
+// params: table - an AllocSite table; capacity - its capacity, a power of two; name - a call site's __func__
+// returns: the slot holding that call site, or the empty slot where it belongs
+AllocSite *siteSlot(AllocSite *table, size_t capacity, const char *name) {
+    size_t index = ((uintptr_t)name >> 3) * 0x9E3779B97F4A7C15ull;
+    while (true) {
+        index &= capacity - 1;
+        if (table[index].name == NULL || table[index].name == name) {
+            return &table[index];
+        }
+        index++;
+    }
+}
+
+// recordSite
+// params: name - the calling function's __func__; size - the number of bytes it asked for
+// returns: Nothing
+// adds one object of size bytes to the call site's counts, growing the table when it gets half full
+void recordSite(const char *name, size_t size) {
+    pthread_mutex_lock(&profileLock);
+    if ((siteCount + 1) * 2 > siteCapacity) {
+        size_t capacity = siteCapacity == 0 ? 64 : siteCapacity * 2;
+        AllocSite *table = calloc(capacity, sizeof(AllocSite));
+        if (table == NULL) {
+            printf("Error: out of memory\n");
+            exit(1);
+        }
+        for (size_t i = 0; i < siteCapacity; i++) {
+            if (sites[i].name != NULL) {
+                *siteSlot(table, capacity, sites[i].name) = sites[i];
+            }
+        }
+        free(sites);
+        sites = table;
+        siteCapacity = capacity;
+    }
+    AllocSite *site = siteSlot(sites, siteCapacity, name);
+    if (site -> name == NULL) {
+        site -> name = name;
+        siteCount++;
+    }
+    site -> objects++;
+    site -> bytes += size;
+    pthread_mutex_unlock(&profileLock);
+}
+
+// checkProfiling
+// params: None
+// returns: Nothing
+// turns profiling on if SCHEME_TALLOC_PROFILE is set
+void checkProfiling() {
+    char *setting = getenv("SCHEME_TALLOC_PROFILE");
+    profiling = setting != NULL && strcmp(setting, "0") != 0;
+}
+
+// profilingOn
+// params: None
+// returns: true if allocations should be recorded
+bool profilingOn() {
+    pthread_once(&profilingChecked, checkProfiling);
+    return profiling;
+}
+
+// compareSites
+// params: first, second - pointers to AllocSites
+// returns: a negative number if first allocated more bytes than second, positive if fewer, 0 if the same
+int compareSites(const void *first, const void *second) {
+    const AllocSite *a = first;
+    const AllocSite *b = second;
+    if (a -> bytes != b -> bytes) {
+        return a -> bytes > b -> bytes ? -1 : 1;
+    }
+    return strcmp(a -> name, b -> name);
+}
+
+// printProfile
+// params: None
+// returns: Nothing
+// prints every call site's counts to stderr, biggest first, then forgets them
+void printProfile() {
+    if (siteCount == 0) {
+        return;
+    }
+    size_t count = 0;
+    size_t objects = 0;
+    size_t bytes = 0;
+    for (size_t i = 0; i < siteCapacity; i++) {
+        if (sites[i].name != NULL) {
+            objects += sites[i].objects;
+            bytes += sites[i].bytes;
+            sites[count++] = sites[i];
+        }
+    }
+    qsort(sites, count, sizeof(AllocSite), compareSites);
+
+    fprintf(stderr, "talloc profile: %zu objects, %zu bytes\n", objects, bytes);
+    fprintf(stderr, "%14s %12s  %s\n", "bytes", "objects", "site");
+    for (size_t i = 0; i < count; i++) {
+        fprintf(stderr, "%14zu %12zu  %s\n", sites[i].bytes, sites[i].objects, sites[i].name);
+    }
+    free(sites);
+    sites = NULL;
+    siteCapacity = 0;
+    siteCount = 0;
+}
+
+// tallocAt
+// params: size - the number of bytes requested to allocate; site - the name of the calling function
+// returns: a pointer to the allocated block
+// talloc with the call site passed along for allocation profiling; talloc.h routes every call to talloc here
+void *tallocAt(size_t size, const char *site) {
+    if (profilingOn()) {
+        recordSite(site, size);
+    }
+    TallocContext *context = activeContext();
+    Pool *pool = poolFor(context, size);
+    if (pool != NULL) {
+        if (nurseryTarget > 0) {
+            return nurseryAlloc(size);
+        }
+        return poolAlloc(pool);
+    }
+    return arenaAlloc(context, size);
+}
+
+// tallocFrameAt
+// params: size - the size of a Frame in bytes; site - the name of the calling function
+// returns: a pointer to the allocated Frame
+// like talloc, but for a Frame, from the nursery if there is one and otherwise from its size class's pool; a frame
+// bigger than the biggest class is reported as an evaluation error. talloc.h routes every call to tallocFrame here
+void *tallocFrameAt(size_t size, const char *site) {
+    if (size > LARGE_FRAME) {
+        printf("Evaluation error: too many variables in one frame\n");
+        texit(0);
+    }
+    if (profilingOn()) {
+        recordSite(site, size);
+    }
+    Pool *pool = framePoolFor(activeContext(), size);
+    if (nurseryTarget > 0) {
+        return nurseryAlloc(size);
+    }
+    return poolAlloc(pool);
+}
+
+// tallocFrame
+// params: size - the size of a Frame in bytes
+// returns: a pointer to the allocated Frame
+void *tallocFrame(size_t size) {
+    return tallocFrameAt(size, "tallocFrame");
+}
+
+// tallocStaticAt
+// params: size - the number of bytes requested to allocate, at most LARGE_REQUEST; site - the name of the calling
+//         function
+// returns: a pointer to the allocated block
+// like tallocBytes, but the block is sure to be in an ordinary arena chunk, where tallocIsStatic can recognize it.
+// talloc.h routes every call to tallocStatic here
+void *tallocStaticAt(size_t size, const char *site) {
+    assert(size <= LARGE_REQUEST);
+    if (profilingOn()) {
+        recordSite(site, size);
+    }
+    return arenaAlloc(activeContext(), size);
+}
+
+// tallocStatic
+// params: size - the number of bytes requested to allocate, at most LARGE_REQUEST
+// returns: a pointer to the allocated block
+void *tallocStatic(size_t size) {
+    return tallocStaticAt(size, "tallocStatic");
+}
+
+// tallocBytesAt
+// params: size - the number of bytes requested to allocate; site - the name of the calling function
+// returns: a pointer to the allocated block
+// tallocBytes with the call site passed along for allocation profiling
+void *tallocBytesAt(size_t size, const char *site) {
+    if (profilingOn()) {
+        recordSite(site, size);
+    }
+    return arenaAlloc(activeContext(), size);
+}
 
 // talloc
 // params: size - the number of bytes requested to allocate
 // returns: a pointer to the allocated block
-// talloc operates similary to malloc, but adds a pointer to the newly allocated memory to a global linked list
-// if the global linked list is NULL, it is initialized as a NULL_TYPE
+// talloc operates similary to malloc, allocating from the current context; requests of the size of a Value are served
+// from the nursery while there is one, and otherwise from the Value slab pool; everything else comes from the
+// context's arena
 void *talloc(size_t size) {
-    // if our list has not yet been initialized
-    if (memoryAddresses == NULL) {
-        memoryAddresses = malloc(sizeof(Value));
-        memoryAddresses -> type = NULL_TYPE;
-        // return memoryAddresses;
-    }
-
-    // allocate space for pointer struct
-    Value *newItem = malloc(sizeof(Value));
-    newItem -> type = PTR_TYPE;
-    newItem -> p = malloc(size);
-
-    // allocate space for cons cell containing pointer struct
-    Value *consCell = malloc(sizeof(Value));
-    consCell -> type = CONS_TYPE;
-    consCell -> c.car = newItem;
-    consCell -> c.cdr = memoryAddresses;
-    memoryAddresses = consCell;
-
-    return newItem -> p;
-}
-
-// tfreeHelper
-// params: memoryAddress - a pointer to a Value
-// returns: Nothing
-// a helper function to tfree()
-void tfreeHelper(Value *memoryAddress) {
-    switch (memoryAddress -> type) {
-            case INT_TYPE:
-                break;
-            case DOUBLE_TYPE:
-                break;
-            case STR_TYPE:
-                break;
-            case OPEN_TYPE:
-                break;
-            case CLOSE_TYPE:
-                break;
-            case BOOL_TYPE:
-                break;
-            case SYMBOL_TYPE:
-                break;
-            case PTR_TYPE:
-                free(memoryAddress -> p);
-                free(memoryAddress);
-                break;
-            case CONS_TYPE:
-                tfreeHelper(memoryAddress -> c.car);
-                tfreeHelper(memoryAddress -> c.cdr);
-                free(memoryAddress);
-                break;
-            case NULL_TYPE:
-                free(memoryAddress);
-                break;
-            case VOID_TYPE:
-                break;
-            case CLOSURE_TYPE:
-                break;
-            default:
-                break;
+    return tallocAt(size, "talloc");
+}
+
+// trelease
+// params: pointer - a pointer returned by talloc; size - the size that was passed to talloc for it
+// returns: Nothing
+// hands a Value back to its slab so the next allocation of that size can reuse it
+// memory from the general arena can't be released on its own, so for other sizes this does nothing
+void trelease(void *pointer, size_t size) {
+    // nursery objects are reclaimed by the next minor collection anyway, and a slab that is being swept will pick
+    // the slot up itself if nothing references it
+    if (pointer == NULL || poolFor(&rootContext, size) == NULL || tallocIsYoung(pointer)) {
+        return;
+    }
+
+    Slab *slab = slabOf(pointer);
+    if (slab -> detached || slab -> pool -> owner != threadId()) {
+        return;
+    }
+    Pool *pool = slab -> pool;
+    assert(pool -> objectSize == size);
+    pool -> inUse -= size;
+    pooledBytes -= size;
+    *(void **)pointer = slab -> freeList;
+    slab -> freeList = pointer;
+
+    if (slab != pool -> current && !slab -> partial) {
+        slab -> partial = true;
+        slab -> nextPartial = pool -> partial;
+        pool -> partial = slab;
+    }
+}
+
+// tallocBytes
+// params: size - the number of bytes requested to allocate
+// returns: a pointer to the allocated block
+// like talloc, but always allocates from the current context's arena, even if size happens to equal the size of
+// a Value; use it for strings and other raw data so they never end up in a pool the collector sweeps
+void *tallocBytes(size_t size) {
+    return tallocBytesAt(size, "tallocBytes");
+}
+
+// payloadOf
+// params: memory - a pointer returned by tallocPayload
+// returns: a pointer to the memory's header
+Payload *payloadOf(void *memory) {
+    return (Payload *)((char *)memory - alignUp(sizeof(Payload)));
+}
+
+// linkPayload
+// params: list - a pointer to the head of a list of payloads; payload - a pointer to a payload on no list
+// returns: Nothing
+void linkPayload(Payload **list, Payload *payload) {
+    payload -> next = *list;
+    payload -> link = list;
+    if (*list != NULL) {
+        (*list) -> link = &payload -> next;
+    }
+    *list = payload;
+}
+
+// unlinkPayload
+// params: payload - a pointer to a payload on a list
+// returns: Nothing
+void unlinkPayload(Payload *payload) {
+    *payload -> link = payload -> next;
+    if (payload -> next != NULL) {
+        payload -> next -> link = payload -> link;
+    }
+}
+
+// releasePayload
+// params: payload - a pointer to a payload that is on no list, or on one that is being thrown away
+// returns: Nothing
+// runs the payload's cleanup function, if it has one, then frees it
+void releasePayload(Payload *payload) {
+    if (payload -> cleanup != NULL) {
+        payload -> cleanup((char *)payload + alignUp(sizeof(Payload)));
+    }
+    bigFree(payload, payload -> size);
+}
+
+// adoptPayload
+// params: payload - a pointer to a payload on no list; owner - the Value it belongs to now
+// returns: Nothing
+// puts the payload on the list for its owner: this thread's list of young payloads if the owner is in the nursery,
+// otherwise the current context's list
+void adoptPayload(Payload *payload, void *owner) {
+    payload -> owner = owner;
+    if (tallocIsYoung(owner)) {
+        linkPayload(&youngPayloads, payload);
+    } else {
+        linkPayload(&activeContext() -> payloads, payload);
+        payloadBytes += payload -> size;
+    }
+}
+
+// tallocPayloadAt
+// params: owner - a pointer to a Value; size - the number of bytes requested to allocate; site - the name of the
+//         calling function
+// returns: a pointer to the allocated block, which belongs to owner
+// a payload for a nursery object counts towards filling the nursery, so a loop that makes big vectors and drops them
+// straight away gets a minor collection about as often as one that makes as many bytes of lists
+void *tallocPayloadAt(void *owner, size_t size, const char *site) {
+    if (profilingOn()) {
+        recordSite(site, size);
+    }
+    size_t header = alignUp(sizeof(Payload));
+    Payload *payload = bigAlloc(header + size);
+    payload -> size = header + size;
+    payload -> cleanup = NULL;
+    adoptPayload(payload, owner);
+    if (tallocIsYoung(owner)) {
+        nurseryAllocated += payload -> size;
+    }
+    return (char *)payload + header;
+}
+
+// tallocPayload
+// params: owner - a pointer to a Value; size - the number of bytes requested to allocate
+// returns: a pointer to the allocated block, which belongs to owner
+void *tallocPayload(void *owner, size_t size) {
+    return tallocPayloadAt(owner, size, "tallocPayload");
+}
+
+// tallocPayloadFree
+// params: memory - a pointer returned by tallocPayload
+// returns: Nothing
+// frees the payload now, for an owner that has stopped using it
+void tallocPayloadFree(void *memory) {
+    Payload *payload = payloadOf(memory);
+    unlinkPayload(payload);
+    if (!tallocIsYoung(payload -> owner)) {
+        payloadBytes -= payload -> size;
+    }
+    releasePayload(payload);
+}
+
+// tallocPayloadAdopt
+// params: memory - a pointer returned by tallocPayload; owner - a pointer to a Value
+// returns: Nothing
+// hands the payload over to a new owner, in place of the one it was allocated for
+void tallocPayloadAdopt(void *memory, void *owner) {
+    Payload *payload = payloadOf(memory);
+    unlinkPayload(payload);
+    if (!tallocIsYoung(payload -> owner)) {
+        payloadBytes -= payload -> size;
+    }
+    adoptPayload(payload, owner);
+}
+
+// tallocPayloadCleanup
+// params: memory - a pointer returned by tallocPayload; cleanup - a function to call on memory, or NULL
+// returns: Nothing
+// has cleanup called on the payload just before it is freed, however that happens, to let go of whatever else the
+// payload holds
+void tallocPayloadCleanup(void *memory, void (*cleanup)(void *memory)) {
+    payloadOf(memory) -> cleanup = cleanup;
+}
+
+// isMarked
+// params: object - a pointer to a Value that isn't in the nursery
+// returns: true if the object is static, belongs to another thread, or has its mark bit set
+bool isMarked(void *object) {
+    if (tallocIsStatic(object)) {
+        return true;
+    }
+    Slab *slab = slabOf(object);
+    if (slab -> pool -> owner != threadId()) {
+        return true;
+    }
+    size_t index = (size_t)((char *)object - slab -> start) / slab -> pool -> objectSize;
+    return (slab -> marks[index / 64] & ((uint64_t)1 << (index % 64))) != 0;
+}
+
+// sweepPayloads
+// params: context - a pointer to a TallocContext
+// returns: Nothing
+// frees the payloads whose owners the garbage collector didn't mark, in the context and every context nested inside
+// it; this has to happen before the owners' slots are swept and reused. Other threads' contexts are left alone.
+void sweepPayloads(TallocContext *context) {
+    if (context -> valuePool.owner == threadId()) {
+        Payload *payload = context -> payloads;
+        while (payload != NULL) {
+            Payload *next = payload -> next;
+            if (!isMarked(payload -> owner)) {
+                unlinkPayload(payload);
+                payloadBytes -= payload -> size;
+                releasePayload(payload);
+            }
+            payload = next;
+        }
+    }
+    for (TallocContext *child = context -> children; child != NULL; child = child -> nextSibling) {
+        sweepPayloads(child);
+    }
+}
+
+// freePayloads
+// params: list - a pointer to the head of a list of payloads; counted - whether they count towards payloadBytes
+// returns: Nothing
+// frees every payload on the list, leaving it empty
+void freePayloads(Payload **list, bool counted) {
+    while (*list != NULL) {
+        Payload *payload = *list;
+        *list = payload -> next;
+        if (counted) {
+            payloadBytes -= payload -> size;
+        }
+        releasePayload(payload);
+    }
+}
+
+// tallocMark
+// params: object - a pointer to a Value or Frame allocated from a pool
+// returns: true if the object was not marked before this call, false if it already was
+// sets the object's mark bit, for the garbage collector
+// objects in other threads' pools are never marked (or swept) by this thread, so they count as already marked
+bool tallocMark(void *object) {
+    Slab *slab = slabOf(object);
+    assert(slab -> kind == SLAB_BLOCK);
+    if (slab -> pool -> owner != threadId()) {
+        return false;
+    }
+    size_t index = (size_t)((char *)object - slab -> start) / slab -> pool -> objectSize;
+    uint64_t bit = (uint64_t)1 << (index % 64);
+    if (slab -> marks[index / 64] & bit) {
+        return false;
+    }
+    slab -> marks[index / 64] |= bit;
+    return true;
+}
+
+// tallocRemember
+// params: object - a pointer to a pooled Value or Frame
+// returns: true if the object was not already remembered before this call
+// sets the object's remembered bit, so the collector only adds it to its remembered set once
+bool tallocRemember(void *object) {
+    Slab *slab = slabOf(object);
+    size_t index = (size_t)((char *)object - slab -> start) / slab -> pool -> objectSize;
+    uint64_t bit = (uint64_t)1 << (index % 64);
+    if (slab -> remembered[index / 64] & bit) {
+        return false;
+    }
+    slab -> remembered[index / 64] |= bit;
+    return true;
+}
+
+// tallocForget
+// params: object - a pointer to a pooled Value or Frame
+// returns: Nothing
+// clears the object's remembered bit
+void tallocForget(void *object) {
+    Slab *slab = slabOf(object);
+    size_t index = (size_t)((char *)object - slab -> start) / slab -> pool -> objectSize;
+    slab -> remembered[index / 64] &= ~((uint64_t)1 << (index % 64));
+}
+
+// tallocNurseryEnable
+// params: size - the number of bytes the nursery should hold between minor collections, or 0 for no nursery
+// returns: Nothing
+// from now on Values and Frames are allocated in the nursery (or, with size 0, straight from the pools)
+void tallocNurseryEnable(size_t size) {
+    nurseryTarget = size;
+}
+
+// tallocNurseryFull
+// params: None
+// returns: true if the nursery has had at least its target number of bytes allocated since the last minor collection
+bool tallocNurseryFull() {
+    return nurseryTarget > 0 && nurseryAllocated >= nurseryTarget;
+}
+
+// tallocForwarded
+// params: object - a pointer to a Value or Frame in the nursery
+// returns: the object's copy outside the nursery, or NULL if it hasn't been copied yet
+void *tallocForwarded(void *object) {
+    NurseryBlock *block = (NurseryBlock *)slabOf(object);
+    size_t index = (size_t)((char *)object - block -> start) / ALIGNMENT;
+    if (block -> forwarded[index / 64] & ((uint64_t)1 << (index % 64))) {
+        return *(void **)object;
+    }
+    return NULL;
+}
+
+// tallocForward
+// params: object - a pointer to a Value or Frame in the nursery; copy - a pointer to its copy outside the nursery
+// returns: Nothing
+// records that the object has been copied, overwriting its first word with the copy's address
+void tallocForward(void *object, void *copy) {
+    NurseryBlock *block = (NurseryBlock *)slabOf(object);
+    size_t index = (size_t)((char *)object - block -> start) / ALIGNMENT;
+    block -> forwarded[index / 64] |= (uint64_t)1 << (index % 64);
+    *(void **)object = copy;
+}
+
+// tallocPromote
+// params: size - sizeof(Value), or the size of a Frame; isFrame - which of the two it is
+// returns: a pointer to a free slot in this thread's home context's pool for that size
+// where minor collections copy surviving nursery objects to
+void *tallocPromote(size_t size, bool isFrame) {
+    activeContext();
+    return poolAlloc(isFrame ? framePoolFor(homeContext, size) : poolFor(homeContext, size));
+}
+
+// promotePayloads
+// params: None
+// returns: Nothing
+// after a minor collection has copied everything live out of the nursery, frees the payloads whose owners weren't
+// copied and moves the rest to the home context's list, along with their owners
+void promotePayloads() {
+    Payload *payload = youngPayloads;
+    youngPayloads = NULL;
+    while (payload != NULL) {
+        Payload *next = payload -> next;
+        void *copy = tallocForwarded(payload -> owner);
+        if (copy == NULL) {
+            releasePayload(payload);
+        } else {
+            payload -> owner = copy;
+            linkPayload(&homeContext -> payloads, payload);
+            payloadBytes += payload -> size;
+        }
+        payload = next;
+    }
+}
+
+// tallocNurseryReset
+// params: None
+// returns: Nothing
+// empties the nursery after a minor collection has copied everything live out of it, first freeing the payloads of
+// the objects that weren't copied
+// blocks beyond the nursery's target size are given back to the system
+void tallocNurseryReset() {
+    promotePayloads();
+    size_t kept = 0;
+    NurseryBlock **link = &nurseryBlocks;
+    while (*link != NULL) {
+        NurseryBlock *block = *link;
+        if (kept >= nurseryTarget) {
+            *link = block -> next;
+            giveBlock(block);
+            continue;
         }
+        kept += SLAB_SIZE;
+        block -> bump = block -> start;
+        memset(block -> forwarded, 0, sizeof(block -> forwarded));
+        link = &block -> next;
+    }
+    nurseryCurrent = nurseryBlocks;
+    nurseryAllocated = 0;
+}
+
+// freeNursery
+// params: None
+// returns: Nothing
+// gives every nursery block back to the system, and frees the payloads of the objects in them
+void freeNursery() {
+    freePayloads(&youngPayloads, false);
+    while (nurseryBlocks != NULL) {
+        NurseryBlock *next = nurseryBlocks -> next;
+        giveBlock(nurseryBlocks);
+        nurseryBlocks = next;
+    }
+    nurseryCurrent = NULL;
+    nurseryAllocated = 0;
+}
+
+// sweepSlab
+// params: slab - a pointer to a Slab that has been taken out of its pool
+// returns: Nothing
+// puts every unmarked slot in the slab on its free list, counts the marked ones and clears the marks for the next
+// collection; this only touches the slab itself, so the sweeper thread can run it
+void sweepSlab(Slab *slab) {
+    size_t objectSize = slab -> pool -> objectSize;
+    size_t count = (size_t)(slab -> bump - slab -> start) / objectSize;
+    size_t marked = 0;
+    void *freeList = NULL;
+
+    // walk backwards so the free list comes out in address order
+    for (size_t index = count; index > 0; index--) {
+        if (slab -> marks[(index - 1) / 64] & ((uint64_t)1 << ((index - 1) % 64))) {
+            marked++;
+        } else {
+            void *slot = slab -> start + (index - 1) * objectSize;
+            *(void **)slot = freeList;
+            freeList = slot;
+        }
+    }
+    memset(slab -> marks, 0, sizeof(slab -> marks));
+    slab -> freeList = freeList;
+    slab -> live = marked;
+}
+
+// reattachSlab
+// params: slab - a pointer to a Slab that has been swept
+// returns: Nothing
+// puts the slab back in its pool, as a partial slab if it has room; slabs with nothing marked are given back to the
+// system
+void reattachSlab(Slab *slab) {
+    Pool *pool = slab -> pool;
+    sweepOutstanding--;
+    if (slab -> live == 0) {
+        giveBlock(slab);
+        return;
+    }
+
+    slab -> detached = false;
+    slab -> next = pool -> slabs;
+    pool -> slabs = slab;
+    slab -> partial = false;
+    if (slab -> freeList != NULL || slab -> bump < slab -> limit) {
+        slab -> partial = true;
+        slab -> nextPartial = pool -> partial;
+        pool -> partial = slab;
+    }
+    pool -> inUse += slab -> live * pool -> objectSize;
+    pooledBytes += slab -> live * pool -> objectSize;
+}
+
+// detachPool
+// params: pool - a pointer to a Pool; queue - a pointer to the list of slabs waiting to be swept
+// returns: Nothing
+// moves every slab in the pool onto the queue, leaving the pool empty; its objects stop counting towards
+// pooledBytes until their slab is swept and put back. Other threads' pools are left alone.
+void detachPool(Pool *pool, Slab **queue) {
+    if (pool -> owner != threadId()) {
+        return;
+    }
+    Slab *slab = pool -> slabs;
+    while (slab != NULL) {
+        Slab *next = slab -> next;
+        slab -> detached = true;
+        slab -> next = *queue;
+        *queue = slab;
+        sweepOutstanding++;
+        slab = next;
+    }
+    pooledBytes -= pool -> inUse;
+    pool -> inUse = 0;
+    pool -> slabs = NULL;
+    pool -> current = NULL;
+    pool -> partial = NULL;
+}
+
+// detachContext
+// params: context - a pointer to a TallocContext; queue - a pointer to the list of slabs waiting to be swept
+// returns: Nothing
+// detaches the pools of the context and of every context nested inside it
+void detachContext(TallocContext *context, Slab **queue) {
+    detachPool(&context -> valuePool, queue);
+    for (int index = 0; index < FRAME_CLASSES; index++) {
+        detachPool(&context -> framePools[index], queue);
+    }
+    TallocContext *child = context -> children;
+    while (child != NULL) {
+        detachContext(child, queue);
+        child = child -> nextSibling;
+    }
+}
+
+// sweeperMain
+// params: unused - ignored
+// returns: NULL
+// the background sweeper thread: sweeps queued slabs and hands them back until it is asked to stop
+void *sweeperMain(void *unused) {
+    (void)unused;
+    pthread_mutex_lock(&sweepLock);
+    while (true) {
+        while (sweepQueue == NULL && !sweeperStopping) {
+            pthread_cond_wait(&sweepWork, &sweepLock);
+        }
+        if (sweepQueue == NULL) {
+            break;
+        }
+        Slab *slab = sweepQueue;
+        sweepQueue = slab -> next;
+        pthread_mutex_unlock(&sweepLock);
+
+        sweepSlab(slab);
+
+        pthread_mutex_lock(&sweepLock);
+        slab -> next = sweptQueue;
+        sweptQueue = slab;
+        pthread_cond_signal(&sweepDone);
+    }
+    pthread_mutex_unlock(&sweepLock);
+    return NULL;
+}
+
+// stopSweeper
+// params: None
+// returns: Nothing
+// waits for the background sweeper thread, if there is one, to finish its queue and exit
+void stopSweeper() {
+    if (!sweeperRunning) {
+        return;
+    }
+    pthread_mutex_lock(&sweepLock);
+    sweeperStopping = true;
+    pthread_cond_signal(&sweepWork);
+    pthread_mutex_unlock(&sweepLock);
+    pthread_join(sweeper, NULL);
+    sweeperRunning = false;
+    sweeperStopping = false;
+}
+
+// tallocSweepBegin
+// params: background - whether a background thread should do the sweeping
+// returns: Nothing
+// frees the payloads of unmarked Values, then takes every slab, in every context, out of its pool to be swept; call
+// tallocSweepStep until it returns true to finish. New Values and Frames go to fresh slabs in the meantime.
+void tallocSweepBegin(bool background) {
+    Slab *queue = NULL;
+    pthread_mutex_lock(&contextLock);
+    sweepPayloads(&rootContext);
+    detachContext(&rootContext, &queue);
+    pthread_mutex_unlock(&contextLock);
+
+    if (background && !sweeperRunning) {
+        sweeperRunning = pthread_create(&sweeper, NULL, sweeperMain, NULL) == 0;
+    }
+    pthread_mutex_lock(&sweepLock);
+    while (queue != NULL) {
+        Slab *next = queue -> next;
+        queue -> next = sweepQueue;
+        sweepQueue = queue;
+        queue = next;
+    }
+    if (background) {
+        pthread_cond_signal(&sweepWork);
+    }
+    pthread_mutex_unlock(&sweepLock);
+}
+
+// tallocSweepStep
+// params: budget - the most slabs to sweep on this thread before returning
+// returns: true once every slab taken out by tallocSweepBegin has been swept and put back
+// puts back whatever the sweeper thread has finished, then sweeps up to budget queued slabs itself
+bool tallocSweepStep(size_t budget) {
+    pthread_mutex_lock(&sweepLock);
+    Slab *swept = sweptQueue;
+    sweptQueue = NULL;
+    pthread_mutex_unlock(&sweepLock);
+    while (swept != NULL) {
+        Slab *next = swept -> next;
+        reattachSlab(swept);
+        swept = next;
+    }
+
+    while (budget > 0 && sweepOutstanding > 0) {
+        pthread_mutex_lock(&sweepLock);
+        Slab *slab = sweepQueue;
+        if (slab != NULL) {
+            sweepQueue = slab -> next;
+        }
+        pthread_mutex_unlock(&sweepLock);
+        if (slab == NULL) {
+            break;
+        }
+        sweepSlab(slab);
+        reattachSlab(slab);
+        budget--;
+    }
+    if (sweepOutstanding > 0) {
+        return false;
+    }
+    // with the sweep done, heapInUse is what survived; run early next time once half of what's left is used
+    size_t inUse = atomic_load_explicit(&heapInUse, memory_order_relaxed);
+    if (heapLimit > inUse) {
+        atomic_store_explicit(&pressureMark, inUse + (heapLimit - inUse) / 2, memory_order_relaxed);
+    }
+    return true;
+}
+
+// tallocSweepFinish
+// params: None
+// returns: Nothing
+// helps sweep whatever is left of the current sweep, if there is one, and waits for the sweeper thread's share
+void tallocSweepFinish() {
+    while (!tallocSweepStep(SIZE_MAX)) {
+        pthread_mutex_lock(&sweepLock);
+        while (sweptQueue == NULL) {
+            pthread_cond_wait(&sweepDone, &sweepLock);
+        }
+        pthread_mutex_unlock(&sweepLock);
+    }
+}
+
+// tallocSweep
+// params: None
+// returns: the number of pooled bytes still in use afterwards
+// frees every Value and Frame, in every context, that the garbage collector did not mark
+size_t tallocSweep() {
+    tallocSweepFinish();
+    tallocSweepBegin(false);
+    tallocSweepFinish();
+    return pooledBytes + payloadBytes;
+}
+
+// tallocPooledBytes
+// params: None
+// returns: the number of bytes currently handed out from Value and Frame pools, plus those held by the payloads of
+// Values outside the nursery
+size_t tallocPooledBytes() {
+    return pooledBytes + payloadBytes;
+}
+
+// tcontextNew
+// params: parent - a pointer to the TallocContext to nest the new one in, or NULL for the root context
+// returns: a pointer to a new, empty TallocContext
+TallocContext *tcontextNew(TallocContext *parent) {
+    if (parent == NULL) {
+        parent = &rootContext;
+    }
+    TallocContext *context = malloc(sizeof(TallocContext));
+    if (context == NULL) {
+        printf("Error: out of memory\n");
+        exit(1);
+    }
+    context -> parent = parent;
+    context -> children = NULL;
+    context -> chunks = NULL;
+    context -> payloads = NULL;
+    initPools(context, threadId());
+    pthread_mutex_lock(&contextLock);
+    context -> nextSibling = parent -> children;
+    parent -> children = context;
+    pthread_mutex_unlock(&contextLock);
+    return context;
+}
+
+// tcontextCurrent
+// params: None
+// returns: a pointer to the TallocContext talloc currently allocates from
+TallocContext *tcontextCurrent() {
+    return activeContext();
+}
+
+// tcontextSwitch
+// params: context - a pointer to a TallocContext
+// returns: a pointer to the TallocContext that was current before the switch
+// makes talloc allocate from the given context until the next switch
+TallocContext *tcontextSwitch(TallocContext *context) {
+    TallocContext *previous = activeContext();
+    currentContext = context;
+    return previous;
+}
+
+// unlinkContext
+// params: context - a pointer to a non-root TallocContext
+// returns: Nothing
+// removes the context from its parent's list of children
+void unlinkContext(TallocContext *context) {
+    pthread_mutex_lock(&contextLock);
+    TallocContext **link = &context -> parent -> children;
+    while (*link != context) {
+        link = &(*link) -> nextSibling;
+    }
+    *link = context -> nextSibling;
+    pthread_mutex_unlock(&contextLock);
+}
+
+// fallbackContext
+// params: context - a pointer to the parent of a context that is being freed
+// returns: the context to allocate from instead of the freed one: the parent if it belongs to this thread, otherwise
+// NULL, meaning this thread's home context
+TallocContext *fallbackContext(TallocContext *context) {
+    return context -> valuePool.owner == threadId() ? context : NULL;
+}
+
+// releaseContext
+// params: context - a pointer to a TallocContext
+// returns: Nothing
+// frees the memory owned by the context and all of its descendants, payloads included, and every descendant's struct
+// if the current context is among the ones freed, talloc falls back to allocating from the given context's parent
+void releaseContext(TallocContext *context) {
+    TallocContext *child = context -> children;
+    while (child != NULL) {
+        TallocContext *next = child -> nextSibling;
+        releaseContext(child);
+        if (currentContext == child) {
+            currentContext = fallbackContext(context);
+        }
+        free(child);
+        child = next;
+    }
+    context -> children = NULL;
+
+    freePool(&context -> valuePool);
+    for (int index = 0; index < FRAME_CLASSES; index++) {
+        freePool(&context -> framePools[index]);
+    }
+    freeChunks(context -> chunks);
+    context -> chunks = NULL;
+    freePayloads(&context -> payloads, context -> valuePool.owner == threadId());
 }
 
 // tfree
 // params: None
 // returns: Nothing
-// calls tfreeHelper() to recursively free all pointers to blocks of memory allocated by talloc
-// resets the global linked list to NULL
+// frees every context, slab and chunk allocated through talloc, in O(contexts + slabs + chunks), including other
+// threads' contexts, so no other thread may be using talloc at the time
+// afterwards this thread allocates from its (now empty) home context again, if that was the root context
 void tfree() {
-    tfreeHelper(memoryAddresses);
-    memoryAddresses = NULL;
+    printProfile();
+    tallocSweepFinish();
+    stopSweeper();
+    freeNursery();
+    releaseContext(&rootContext);
+    releaseBlocks();
+    if (homeContext != &rootContext) {
+        homeContext = NULL;
+    }
+    currentContext = homeContext;
+}
+
+// tcontextFree
+// params: context - a pointer to a TallocContext
+// returns: Nothing
+// frees the context and everything allocated in it or in any context nested inside it
+// freeing the root context is the same as calling tfree
+void tcontextFree(TallocContext *context) {
+    if (context == NULL || context == &rootContext) {
+        tfree();
+        return;
+    }
+    tallocSweepFinish();
+    releaseContext(context);
+    if (currentContext == context) {
+        currentContext = fallbackContext(context -> parent);
+    }
+    unlinkContext(context);
+    free(context);
+}
+
+// mergePool
+// params: into - a pointer to a Pool; from - a pointer to a Pool with the same object size
+// returns: Nothing
+// moves every slab in from into the other pool, leaving from empty
+void mergePool(Pool *into, Pool *from) {
+    Slab *slab = from -> slabs;
+    while (slab != NULL) {
+        Slab *next = slab -> next;
+        slab -> pool = into;
+        slab -> next = into -> slabs;
+        into -> slabs = slab;
+
+        // the other pool keeps its own current slab, so anything with room left becomes a partial slab there
+        if (!slab -> partial && (slab -> freeList != NULL || slab -> bump < slab -> limit)) {
+            slab -> partial = true;
+            slab -> nextPartial = into -> partial;
+            into -> partial = slab;
+        }
+        slab = next;
+    }
+
+    // slabs that were already partial are still linked through nextPartial, so splice that list on as well
+    Slab *partial = from -> partial;
+    while (partial != NULL) {
+        Slab *next = partial -> nextPartial;
+        partial -> nextPartial = into -> partial;
+        into -> partial = partial;
+        partial = next;
+    }
+    into -> inUse += from -> inUse;
+    from -> inUse = 0;
+    from -> slabs = NULL;
+    from -> current = NULL;
+    from -> partial = NULL;
+}
+
+// tcontextMerge
+// params: context - a pointer to a non-root TallocContext
+// returns: Nothing
+// hands everything allocated in the context, including its child contexts, over to its parent and frees the
+// context itself; use this when memory allocated as scratch turns out to be needed for longer
+void tcontextMerge(TallocContext *context) {
+    if (context == NULL || context == &rootContext) {
+        return;
+    }
+    TallocContext *parent = context -> parent;
+
+    tallocSweepFinish();
+    mergePool(&parent -> valuePool, &context -> valuePool);
+    for (int index = 0; index < FRAME_CLASSES; index++) {
+        mergePool(&parent -> framePools[index], &context -> framePools[index]);
+    }
+
+    // keep the parent's current chunk at the head so it carries on being bumped
+    if (parent -> chunks == NULL) {
+        parent -> chunks = context -> chunks;
+    } else if (context -> chunks != NULL) {
+        Chunk *last = context -> chunks;
+        while (last -> next != NULL) {
+            last = last -> next;
+        }
+        last -> next = parent -> chunks -> next;
+        parent -> chunks -> next = context -> chunks;
+    }
+
+    while (context -> payloads != NULL) {
+        Payload *payload = context -> payloads;
+        unlinkPayload(payload);
+        linkPayload(&parent -> payloads, payload);
+    }
+
+    pthread_mutex_lock(&contextLock);
+    TallocContext *child = context -> children;
+    while (child != NULL) {
+        TallocContext *next = child -> nextSibling;
+        child -> parent = parent;
+        child -> nextSibling = parent -> children;
+        parent -> children = child;
+        child = next;
+    }
+    context -> children = NULL;
+    pthread_mutex_unlock(&contextLock);
+
+    if (currentContext == context) {
+        currentContext = fallbackContext(parent);
+    }
+    unlinkContext(context);
+    free(context);
 }
 
 // texit
@@ -98,4 +1895,3 @@ void texit(int status) {
 }
 
 #endif
-
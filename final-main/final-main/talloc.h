@@ -1,20 +1,192 @@
 #include <stdlib.h>
+#include <stdbool.h>
 #include "value.h"
 
 #ifndef _TALLOC
 #define _TALLOC
 
-// Replacement for malloc that stores the pointers allocated. It should store
-// the pointers in some kind of list; a linked list would do fine, but insert
-// here whatever code you'll need to do so; don't call functions in the
-// pre-existing linkedlist.h. Otherwise you'll end up with circular
-// dependencies, since you're going to modify the linked list to use talloc.
+// Replacement for malloc. Requests of exactly sizeof(Value) come from the
+// garbage collector's nursery when it has one, and otherwise from a
+// fixed-size slab pool that packs Values densely; everything else is carved
+// out of large arena chunks by bumping a pointer. Don't call
+// functions in linkedlist.h from here; the linked list uses talloc, so that
+// would be a circular dependency.
 void *talloc(size_t size);
 
-// Free all pointers allocated by talloc, as well as whatever memory you
-// allocated in lists to hold those pointers.
+// Allocate a Frame of size bytes (see FRAME_BYTES in value.h) the way talloc
+// allocates a Value: from the nursery, or else from a slab pool for frames of
+// about that size.
+void *tallocFrame(size_t size);
+
+// Like talloc, but always uses the arena, even when size happens to equal the
+// size of a Value. Use this for strings and other raw bytes so the
+// garbage collector never mistakes them for objects.
+void *tallocBytes(size_t size);
+
+// Storage for a Value whose contents don't fit in it, such as a bignum's
+// digits, which belongs to that Value, owner. Unlike the arena, a payload is
+// freed on its own: by the garbage collector once it finds the owner
+// unreachable, or by tallocPayloadFree if the owner replaces it first, and
+// otherwise along with the context it was allocated in. owner must already be
+// allocated, and nothing but owner may point at the payload; to share it with
+// another Value, hand it over with tallocPayloadAdopt. A Value may own more
+// than one payload. A payload that holds on to something talloc doesn't know
+// about, such as a mapping, can be given a cleanup function with
+// tallocPayloadCleanup; it is called on the payload just before it is freed.
+void *tallocPayload(void *owner, size_t size);
+void tallocPayloadFree(void *payload);
+void tallocPayloadAdopt(void *payload, void *owner);
+void tallocPayloadCleanup(void *payload, void (*cleanup)(void *payload));
+
+// Like tallocBytes, for Values (and cells of CDR-coded lists) that the
+// garbage collector should leave alone: they stay where they are until tfree,
+// and tallocIsStatic tells the collector not to mark them or look inside them,
+// so they must never point at a Value it manages. size can't be more than 16k.
+void *tallocStatic(size_t size);
+bool tallocIsStatic(void *object);
+
+// Hand a Value that is no longer referenced back to its pool so it can
+// be reused. size must be the size it was talloc'd with. Other sizes live in
+// the arena until tfree, so releasing them does nothing.
+void trelease(void *pointer, size_t size);
+
+// Free everything allocated by talloc, in every context, by releasing the slabs
+// and arena chunks. This takes time proportional to the number of those, not
+// the number of allocations. If allocation profiling is on, the report is
+// printed first.
 void tfree();
 
+// All of this memory lives in one heap, reserved from the system up front and
+// handed back to it as blocks become free. SCHEME_HEAP_LIMIT caps the heap at
+// that many bytes (a k, m or g suffix may be used); allocating past it is an
+// "out of memory" evaluation error. SCHEME_HEAP_HUGEPAGES=1 asks for the heap
+// to be backed by transparent hugepages.
+
+// Return true if a heap limit is set and the garbage collector should run
+// early to stay under it.
+bool tallocHeapPressure();
+
+// Return the number of bytes named by text, such as "4096", "512k" or "64m".
+size_t tallocParseSize(const char *text);
+
+// Allocation profiling: when the SCHEME_TALLOC_PROFILE environment variable is
+// set, talloc, tallocFrame, tallocBytes, tallocStatic and tallocPayload count
+// the objects and bytes allocated by each calling function, and tfree (and so
+// texit) prints them to stderr, biggest first. The macros below pass the
+// caller's name along; the functions themselves are still real functions, for
+// code compiled without this header, and count their callers under their own
+// names.
+void *tallocAt(size_t size, const char *site);
+void *tallocFrameAt(size_t size, const char *site);
+void *tallocBytesAt(size_t size, const char *site);
+void *tallocStaticAt(size_t size, const char *site);
+void *tallocPayloadAt(void *owner, size_t size, const char *site);
+
+#define talloc(size) tallocAt((size), __func__)
+#define tallocFrame(size) tallocFrameAt((size), __func__)
+#define tallocBytes(size) tallocBytesAt((size), __func__)
+#define tallocStatic(size) tallocStaticAt((size), __func__)
+#define tallocPayload(owner, size) tallocPayloadAt((owner), (size), __func__)
+
+// A context is a group of talloc'd memory that can be freed together. Contexts
+// nest: freeing one also frees every context created inside it. Everything
+// lives in the root context unless a program switches to another one.
+//
+// talloc can be used from several threads at once as long as each thread only
+// allocates from, switches to and frees contexts it created itself. The first
+// thread to allocate owns the root context; every other thread gets a context
+// of its own under the root the first time it allocates. Each thread's current
+// slabs, nursery and arena chunks are private to it, and they are refilled
+// from a pool of free blocks shared by all threads, a batch at a time. The
+// garbage collector functions below only ever mark and sweep the calling
+// thread's contexts, and tfree frees every thread's memory, so it may only be
+// called once the other threads have stopped using talloc.
+typedef struct TallocContext TallocContext;
+
+// Create a new, empty context nested inside parent (NULL means the root).
+TallocContext *tcontextNew(TallocContext *parent);
+
+// Return the context talloc is currently allocating from.
+TallocContext *tcontextCurrent();
+
+// Make talloc allocate from context, and return the previously current one so
+// the caller can switch back.
+TallocContext *tcontextSwitch(TallocContext *context);
+
+// Free everything allocated in context and in all contexts nested inside it.
+// If the current context is freed, talloc goes back to context's parent (or,
+// if that belongs to another thread, to this thread's own context).
+void tcontextFree(TallocContext *context);
+
+// Give everything allocated in context (including nested contexts) to its
+// parent, then free the context itself. For scratch memory that turns out to
+// still be referenced.
+void tcontextMerge(TallocContext *context);
+
+// The following are for the garbage collector in gc.c.
+
+// Set the mark bit of a pooled Value or Frame. Returns true if it wasn't
+// already marked.
+bool tallocMark(void *object);
+
+// Return every unmarked Value and Frame, in every context, to its pool, free
+// the unmarked Values' payloads and clear all marks. Returns the number of
+// pooled bytes still in use.
+size_t tallocSweep();
+
+// Start an incremental sweep: the payloads of unmarked Values are freed, and
+// every slab is taken out of its pool, to be swept by tallocSweepStep or, if
+// background is true, by a sweeper thread as well.
+// Marks must not be set again until the sweep is finished.
+void tallocSweepBegin(bool background);
+
+// Put back slabs the sweeper thread has finished and sweep up to budget more
+// on this thread. Returns true once the sweep started by tallocSweepBegin is
+// complete.
+bool tallocSweepStep(size_t budget);
+
+// Finish the sweep started by tallocSweepBegin, if there is one, on this
+// thread, waiting for the sweeper thread if need be.
+void tallocSweepFinish();
+
+// Return the number of bytes currently handed out from the Value and Frame
+// pools, plus those held by the payloads of Values outside the nursery.
+size_t tallocPooledBytes();
+
+// Allocate Values and Frames in a nursery of about size bytes instead of the
+// pools from now on; 0 goes back to allocating from the pools. Survivors are
+// copied out with tallocPromote/tallocForward and the nursery is then emptied
+// with tallocNurseryReset, which frees the payloads of those that weren't.
+void tallocNurseryEnable(size_t size);
+
+// Return true if the nursery has filled up since the last reset.
+bool tallocNurseryFull();
+
+// Return true if a Value or Frame is in the nursery rather than a pool.
+bool tallocIsYoung(void *object);
+
+// Return the copy a nursery object was forwarded to, or NULL if it hasn't been
+// copied yet.
+void *tallocForwarded(void *object);
+
+// Record that a nursery object has been copied to copy. This overwrites the
+// object's first word.
+void tallocForward(void *object, void *copy);
+
+// Allocate a Value or Frame of the given size in the root context's pools,
+// for an object being promoted out of the nursery.
+void *tallocPromote(size_t size, bool isFrame);
+
+// Empty the nursery once everything live has been copied out of it.
+void tallocNurseryReset();
+
+// Set the remembered bit of a pooled Value or Frame. Returns true if it wasn't
+// already set.
+bool tallocRemember(void *object);
+
+// Clear the remembered bit of a pooled Value or Frame.
+void tallocForget(void *object);
+
 // Replacement for the C function "exit", that consists of two lines: it calls
 // tfree before calling exit. It's useful to have later on; if an error happens,
 // you can exit your program, and all memory is automatically cleaned up.
@@ -0,0 +1,10 @@
+(+ 9223372036854775807 1)
+(- -9223372036854775808 1)
+(- (+ 9223372036854775807 1) 1)
+(* 99999999999999999999 99999999999999999999)
+123456789012345678901234567890
+(< 9223372036854775807 9223372036854775808)
+(= 18446744073709551616 (* 4294967296 4294967296))
+(* 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 25)
+(define square (lambda (x) (* x x)))
+(= (square (square (square (square (square (square 99999)))))) (* (square (square (square (square (square 99999))))) (square (square (square (square (square 99999)))))))
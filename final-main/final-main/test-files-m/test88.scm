@@ -0,0 +1,19 @@
+(define v (make-vector 3 (quote a)))
+v
+(vector-length v)
+(vector-set! v 1 "b")
+(vector-ref v 1)
+v
+(vector 1 2.5 (quote (3 4)) (vector))
+(vector->list (vector 1 2 3))
+(list->vector (quote (x y z)))
+(define w (make-vector 5))
+(vector-fill! w 7)
+w
+(define fill
+  (lambda (vec i)
+    (if (= i (vector-length vec))
+        vec
+        (begin (vector-set! vec i (* i i)) (fill vec (+ i 1))))))
+(vector-ref (fill (make-vector 1000) 0) 999)
+(vector-ref v 3)
@@ -0,0 +1,36 @@
+(define h (make-hash-table))
+(hash-table? h)
+(hash-table-set! h (quote apple) 1)
+(hash-table-set! h "pear" 2)
+(hash-table-set! h 3 (quote three))
+(hash-table-set! h (quote (1 2)) (vector 1 2))
+(hash-table-set! h 99999999999999999999 (quote big))
+(hash-table-ref h (quote apple))
+(hash-table-ref h "pear")
+(hash-table-ref h 3)
+(hash-table-ref h (quote (1 2)))
+(hash-table-ref h (+ 99999999999999999998 1))
+(hash-table-ref/default h (quote banana) 0)
+(hash-table-ref h (quote banana) (lambda () (quote missing)))
+(hash-table-count h)
+(hash-table-set! h (quote apple) 10)
+(hash-table-ref h (quote apple))
+(hash-table-delete! h "pear")
+(hash-table-contains? h "pear")
+(hash-table-count h)
+(equal? (cons (quote (1 2)) (vector 3 "x")) (cons (quote (1 2)) (vector 3 "x")))
+(equal? "abc" "abd")
+(define fill
+  (lambda (table i n)
+    (if (= i n)
+        table
+        (begin (hash-table-set! table i (* i i)) (fill table (+ i 1) n)))))
+(define squares (fill (make-hash-table) 0 5000))
+(hash-table-count squares)
+(hash-table-ref squares 4999)
+(define total 0)
+(hash-table-walk squares (lambda (k v) (set! total (+ total v))))
+total
+(hash-table->alist (fill (make-hash-table) 0 1))
+h
+(hash-table-ref h "pear")
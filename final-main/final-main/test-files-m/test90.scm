@@ -0,0 +1,28 @@
+(define a (f64vector 1 2.5 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19))
+(define b (make-f64vector 19 2))
+a
+(f64vector-length a)
+(f64vector-ref a 1)
+(f64vector-set! b 0 0.5)
+(f64vector-add a b)
+(f64vector-mul a b)
+(f64vector-scale a 3)
+(f64vector-sum a)
+(f64vector-dot a b)
+(f64vector-min a)
+(f64vector-max (f64vector-scale a -1))
+(f64vector->list (f64vector 1 2))
+(define s (list->s64vector (quote (5 -3 9 0 12 7 -8 4 1))))
+s
+(s64vector-sum s)
+(s64vector-dot s s)
+(s64vector-min s)
+(s64vector-max s)
+(s64vector-add s (make-s64vector 9 1))
+(s64vector-mul s s)
+(s64vector-scale s 2)
+(s64vector-sum (s64vector 9223372036854775807 9223372036854775807 2))
+(s64vector-dot (s64vector 9223372036854775807 2) (s64vector 2 2))
+(s64vector? s)
+(f64vector? s)
+(s64vector-set! s 0 1.5)
@@ -0,0 +1,23 @@
+(define b (make-bytevector 8 1))
+b
+(bytevector-u8-set! b 0 255)
+(bytevector-u8-ref b 0)
+(bytevector-s8-ref b 0)
+(bytevector-u16-set! b 2 258)
+b
+(bytevector-u16-ref b 2)
+(bytevector-u16-ref b 2 (quote big))
+(bytevector-s32-set! b 4 -2 (quote big))
+(bytevector-s32-ref b 4 (quote big))
+(bytevector-u32-ref b 4 (quote big))
+(bytevector-u64-set! b 0 18446744073709551615)
+(bytevector-u64-ref b 0)
+(bytevector-s64-ref b 0)
+(bytevector-length (bytevector 1 2 3))
+(bytevector? b)
+(define f (file->bytevector "test-files-m/test91.bin"))
+(bytevector-length f)
+(bytevector-u8-ref f 0)
+(bytevector-u32-ref f 4 (quote big))
+(bytevector-u64-ref f 8)
+(bytevector-u8-set! f 0 1)
@@ -0,0 +1,42 @@
+(define-record-type <point>
+  (make-point x y)
+  point?
+  (x point-x set-point-x!)
+  (y point-y))
+
+(define p (make-point 3 4))
+p
+<point>
+make-point
+(point? p)
+(point? 5)
+(point? (cons 3 4))
+(point-x p)
+(point-y p)
+(set-point-x! p 10)
+(point-x p)
+(+ (point-x p) (point-y p))
+
+; a constructor can take its fields in any order, or only some of them
+(define-record-type node
+  (make-node value)
+  node?
+  (next node-next set-node-next!)
+  (value node-value))
+
+(define a (make-node "a"))
+(define b (make-node "b"))
+(set-node-next! a b)
+(node-value (node-next a))
+a
+(point? a)
+(node? a)
+
+; records are only equal? to themselves
+(define h (make-hash-table))
+(hash-table-set! h a 1)
+(hash-table-set! h b 2)
+(hash-table-ref h b)
+(equal? a a)
+(equal? a b)
+(equal? (make-point 1 2) (make-point 1 2))
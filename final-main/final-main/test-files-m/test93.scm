@@ -0,0 +1,15 @@
+(define x 10)
+(define f (lambda (a b) (define c (+ a b)) (define g (lambda (d) (+ c d x))) (g 1)))
+(f 1 2)
+(define counter (lambda () (let ((n 0)) (lambda () (set! n (+ n 1)) n))))
+(define c1 (counter))
+(c1)
+(c1)
+(set! x 100)
+(f 1 2)
+(letrec ((even? (lambda (n) (if (= n 0) #t (odd? (- n 1))))) (odd? (lambda (n) (if (= n 0) #f (even? (- n 1)))))) (even? 100))
+(let ((x 1) (y 2)) (let ((x y) (y x)) (cons x y)))
+(define h (lambda (p) (define-record-type pt (mk a) pt? (a pa)) (pa (mk p))))
+(h 7)
+(define k (lambda (z) (define z 3) z))
+(k 1)
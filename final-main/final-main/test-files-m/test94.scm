@@ -0,0 +1,24 @@
+(define x 1)
+(define get-x (lambda () x))
+(get-x)
+(set! x 2)
+(get-x)
+(define x 3)
+(get-x)
+x
+(define double (lambda (n) (* n 2)))
+(define twice-double (lambda (n) (double (double n))))
+(twice-double 3)
+(define double (lambda (n) (+ n n n)))
+(twice-double 3)
+(define old-car car)
+(define car (lambda (pair) (old-car (cdr pair))))
+(car (cons 1 (cons 2 3)))
+(set! car old-car)
+(car (cons 1 2))
+(let ((x 10)) (set! x 11) x)
+x
+(define a0 0) (define a1 1) (define a2 2) (define a3 3) (define a4 4)
+(define a5 5) (define a6 6) (define a7 7) (define a8 8) (define a9 9)
+(+ a0 a1 a2 a3 a4 a5 a6 a7 a8 a9)
+(set! undefined-variable 1)
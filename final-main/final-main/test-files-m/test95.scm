@@ -0,0 +1,13 @@
+(define sum5 (lambda (a b c d e) (+ a b c d e)))
+(sum5 1 2 3 4 5)
+(define wide (lambda (a0 a1 a2 a3 a4 a5 a6 a7 a8 a9 b0 b1 b2 b3 b4 b5 b6 b7 b8 b9 c0 c1 c2 c3 c4 c5 c6 c7 c8 c9 d0 d1 d2 d3 d4 d5) (+ a0 a9 b0 b9 c0 c9 d0 d5)))
+(wide 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 25 26 27 28 29 30 31 32 33 34 35 36)
+(define adder (lambda (n) (lambda (m) (+ n m))))
+(define add10 (adder 10))
+(add10 5)
+(let ((x 1) (y 2)) (define z (+ x y)) (* z 10))
+(let ((x 1 2)) x)
+(letrec ((count (lambda (n acc) (if (= n 0) acc (count (- n 1) (+ acc 1)))))) (count 1000 0))
+(define swap (lambda (p q) (let ((p q) (q p)) (cons p q))))
+(swap 1 2)
+(sum5 1 2 3)
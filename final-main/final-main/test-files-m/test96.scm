@@ -0,0 +1,14 @@
+(define get-later (lambda () later))
+(define later 5)
+(get-later)
+(set! later (+ later 1))
+(get-later)
+(define later 7)
+(get-later)
+(define count-down (lambda (n) (if (= n 0) 0 (count-down (- n 1)))))
+(count-down 100)
+(define set-later (lambda (n) (set! later n)))
+(set-later 8)
+later
+(car (cdr (cons 1 (cons 2 3))))
+(never-defined 1)
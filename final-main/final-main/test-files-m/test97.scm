@@ -0,0 +1,13 @@
+(quote (if 1 2 3))
+(quote (lambda (x) (begin x)))
+(define keywords (quote (define let letrec set!)))
+keywords
+(define pick (lambda (flag) (if flag (quote yes) (quote no))))
+(pick #t)
+(pick #f)
+(let ((x 1)) (begin (set! x (+ x 1)) (if (= x 2) (quote two) (quote other))))
+(letrec ((f (lambda (n) (if (= n 0) (quote done) (f (- n 1)))))) (f 10))
+((lambda () (define inner 4) inner))
+(define-record-type point (make-point x y) point? (x point-x) (y point-y))
+(point-x (make-point 3 4))
+(quote)
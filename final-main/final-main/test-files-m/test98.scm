@@ -0,0 +1,34 @@
+(define chunk
+  (lambda (i n)
+    (if (= i 0)
+        (quote ())
+        (cons (+ (* n 1000) i) (chunk (- i 1) n)))))
+(define churn
+  (lambda (i n)
+    (if (= i 0)
+        (quote ())
+        (cons (make-vector 20 (lambda (x) (+ x n))) (churn (- i 1) n)))))
+(define kept (quote ()))
+(define window (quote ()))
+(define rounds
+  (lambda (n)
+    (if (= n 0)
+        (quote done)
+        (begin
+          (set! kept (cons (chunk 200 n) kept))
+          (set! window (churn 200 n))
+          (rounds (- n 1))))))
+(rounds 400)
+(define sum
+  (lambda (list)
+    (if (null? list)
+        0
+        (+ (car list) (sum (cdr list))))))
+(define total
+  (lambda (chunks)
+    (if (null? chunks)
+        0
+        (+ (sum (car chunks)) (total (cdr chunks))))))
+(total kept)
+(car (car kept))
+((vector-ref (car window) 19) 5)
@@ -0,0 +1,16 @@
+(define x 1)
+(define f (lambda () (define y x) (define x 2) (+ x y)))
+(f)
+x
+(define v 10)
+(define m (lambda () (set! v 3) (define v 4) v))
+(m)
+v
+(define g (lambda (a) (let ((h (lambda () (define r a) (define a 7) (+ r a)))) (h))))
+(g 5)
+(define w 1)
+(define n (lambda (w) (let ((k (lambda () (set! w 8) (define w 3) w))) (begin (k) w))))
+(n 2)
+w
+(define p (lambda () (set! nope 1) (define nope 2) nope))
+(p)
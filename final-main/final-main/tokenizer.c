@@ -1,6 +1,8 @@
 #include "value.h"
 #include "linkedlist.h"
 #include "talloc.h"
+#include "bignum.h"
+#include "symbol.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -8,37 +10,62 @@
 #ifndef _TOKENIZER
 #define _TOKENIZER
 
+// where tokenize() puts strings and bignums, which the parse tree uses as they are
+TallocContext *literalContext;
+
 // processString
 // args: None
-// returns: newString - a string
+// returns: a Value of type STR_TYPE holding the string's characters, without the quotes
 // helper method for tokenize() to parse the body of a string. Throws an error and exits if the string is invalid.
-char *processString() {
-    char charRead;
-    int index = 0;
-    char *newString = talloc(301*sizeof(char));  // 301 bytes allocated since max token size of 300, plus null terminator
-    newString[0] = '\"';
-    index++;
-    charRead = (char)fgetc(stdin);
+// The characters are gathered in a buffer that doubles as needed, so a string can be any length.
+Value *processString() {
+    size_t capacity = 64;
+    size_t length = 0;
+    char *buffer = malloc(capacity);
+    int charRead = fgetc(stdin);
 
     // continue reading char's from the input stream until end of string or end of file
     while (charRead != '\"') {
         
         // in the event there is no closing double-quote, throw syntax error
-        if (charRead == EOF) { 
+        if (charRead == EOF || buffer == NULL) { 
+            free(buffer);
             printf("Syntax Error: Invalid String\n");
             texit(0);
         }
-        newString[index] = charRead;
-        index++;
-        charRead = (char)fgetc(stdin);
+        if (length == capacity) {
+            capacity *= 2;
+            char *grown = realloc(buffer, capacity);
+            if (grown == NULL) {
+                free(buffer);
+                printf("Error: out of memory\n");
+                texit(1);
+            }
+            buffer = grown;
+        }
+        buffer[length] = (char)charRead;
+        length++;
+        charRead = fgetc(stdin);
     }
-    newString[index] = '\"';
-    index++;
-    newString[index] = '\0';
-    
+
+    TallocContext *tokenContext = tcontextSwitch(literalContext);
+    Value *newString = makeString(buffer, length);
+    tcontextSwitch(tokenContext);
+    free(buffer);
     return newString;
 }
 
+// literalInteger
+// args: digits - an integer's digits, possibly signed
+// returns: a Value of type INT_TYPE or BIGNUM_TYPE
+// helper method for processNumber(); a bignum's digits go in the literal context, since the parse tree shares them
+Value *literalInteger(char *digits) {
+    TallocContext *tokenContext = tcontextSwitch(literalContext);
+    Value *integer = parseInteger(digits);
+    tcontextSwitch(tokenContext);
+    return integer;
+}
+
 // processNumber
 // args: initialChar - a character
 // returns: a Value of type INT_TYPE or DOUBLE_TYPE, containing an integer or double respectively
@@ -46,7 +73,7 @@ char *processString() {
 Value *processNumber(char initialChar) {
     char charRead = initialChar;
     int index = 0;
-    char *newNumber = talloc(301*sizeof(char));  // 301 bytes allocated since max token size of 300, plus null terminator
+    char *newNumber = tallocBytes(301*sizeof(char));  // 301 bytes allocated since max token size of 300, plus null terminator
     char *dump;  // dump location for excess string contents when converting strings to longs/doubles
 
     // if number is signed, include sign
@@ -66,21 +93,13 @@ Value *processNumber(char initialChar) {
     // create new INT_TYPE token containing the built-up number
     if (charRead == ' ' || charRead == EOF || charRead == '\n') {
         newNumber[index] = '\0';
-        int number = strtol(newNumber, &dump, 10);
-        Value *newToken = talloc(sizeof(Value));
-        newToken -> type = INT_TYPE;
-        newToken -> i = number;
-        return newToken;
+        return literalInteger(newNumber);
 
     // create new INT_TYPE token, but rewind stream by 1 so parentheses will be caught by tokenize()
     } else if (charRead == '(' || charRead == ')') {
         newNumber[index] = '\0';
-        int number = strtol(newNumber, &dump, 10);
-        Value *newToken = talloc(sizeof(Value));
-        newToken -> type = INT_TYPE;
-        newToken -> i = number;
         ungetc(charRead, stdin);
-        return newToken;
+        return literalInteger(newNumber);
     
     // Recognize . symbol to build double
     } else if (charRead == '.') {
@@ -137,7 +156,7 @@ Value *processNumber(char initialChar) {
 // helper function for tokenize(), to identify and tokenize symbols
 Value *processSymbol(char initialChar) {
     char charRead = initialChar;
-    char *symbol = talloc(301*sizeof(char));
+    char symbol[301];  // 301 bytes since max token size of 300, plus null terminator; only the interned copy is kept
     int index = 0;
     symbol[0] = charRead;
     index++;
@@ -162,7 +181,7 @@ Value *processSymbol(char initialChar) {
         symbol[index] = '\0';
         Value *newToken = talloc(sizeof(Value));
         newToken -> type = SYMBOL_TYPE;
-        newToken -> s = symbol;
+        newToken -> s = intern(symbol);
         return newToken;
 
     // create new SYMBOL_TYPE token and rewind by one to catch parens
@@ -170,7 +189,7 @@ Value *processSymbol(char initialChar) {
         symbol[index] = '\0';
         Value *newToken = talloc(sizeof(Value));
         newToken -> type = SYMBOL_TYPE;
-        newToken -> s = symbol;
+        newToken -> s = intern(symbol);
         ungetc(charRead, stdin);
         return newToken;
     
@@ -187,7 +206,9 @@ Value *processSymbol(char initialChar) {
 // args: None
 // returns: a Value containing the first element in a linked-list of tokens
 // reads characters from stdin, and creates the appropriate tokens (or throws a syntax error if it reads an unexpected character)
-Value *tokenize() {
+// string and bignum tokens are allocated in literals (or the current context, if it is NULL) and the rest in the current context
+Value *tokenize(TallocContext *literals) {
+    literalContext = literals != NULL ? literals : tcontextCurrent();
     char charRead;
     Value *list = makeNull();
     charRead = (char)fgetc(stdin);
@@ -199,7 +220,7 @@ Value *tokenize() {
             
             Value *newToken = talloc(sizeof(Value));
             newToken -> type = OPEN_TYPE;
-            char *newString = talloc(2*sizeof(char));
+            char *newString = tallocBytes(2*sizeof(char));
             strcpy(newString, "(");
             newToken -> s = newString;
             list = cons(newToken, list);
@@ -209,7 +230,7 @@ Value *tokenize() {
 
             Value *newToken = talloc(sizeof(Value));
             newToken -> type = CLOSE_TYPE;
-            char *newString = talloc(2*sizeof(char));
+            char *newString = tallocBytes(2*sizeof(char));
             strcpy(newString, ")");
             newToken -> s = newString;
             list = cons(newToken, list);
@@ -217,10 +238,7 @@ Value *tokenize() {
         // case: string
         } else if (charRead == '\"') {
 
-            char *processedString = processString();
-            Value *newToken = talloc(sizeof(Value));
-            newToken -> type = STR_TYPE;
-            newToken -> s = processedString;
+            Value *newToken = processString();
             list = cons(newToken, list);
 
         // case: unsigned integer
@@ -286,15 +304,9 @@ Value *tokenize() {
         } else if (charRead == '#') {
             charRead = (char)fgetc(stdin);
             if (charRead == 't') {
-                Value *newToken = talloc(sizeof(Value));
-                newToken -> type = BOOL_TYPE;
-                newToken -> i = 1;
-                list = cons(newToken, list);
+                list = cons(TRUE_VALUE, list);
             } else if (charRead == 'f') {
-                Value *newToken = talloc(sizeof(Value));
-                newToken -> type = BOOL_TYPE;
-                newToken -> i = 0;
-                list = cons(newToken, list);
+                list = cons(FALSE_VALUE, list);
             } else {
                 printf("Syntax Error: Invalid Boolean\n");
                 texit(0);
@@ -341,17 +353,23 @@ Value *tokenize() {
 void displayTokens(Value *list) {
     Value *currentItem = list;
     Value *currentCar;
-    while (currentItem -> type != NULL_TYPE) {
+    while (typeOf(currentItem) != NULL_TYPE) {
         currentCar = car(currentItem);
-        switch (currentCar -> type) {
+        switch (typeOf(currentCar)) {
             case INT_TYPE:
-                printf("%i:integer\n", currentCar -> i);
+                printf("%lld:integer\n", (long long)intOf(currentCar));
                 break;
+            case BIGNUM_TYPE: {
+                char *text = integerToString(currentCar);
+                printf("%s:integer\n", text);
+                free(text);
+                break;
+            }
             case DOUBLE_TYPE:
                 printf("%lf:double\n", currentCar -> d);
                 break;
             case STR_TYPE:
-                printf("%s:string\n", currentCar -> s);
+                printf("\"%s\":string\n", stringChars(currentCar));
                 break;
             case PTR_TYPE:
                 printf("Pointer\n");
@@ -363,7 +381,7 @@ void displayTokens(Value *list) {
                 printf("%s:close\n", currentCar -> s);
                 break;
             case BOOL_TYPE:
-                if (currentCar -> i == 1) {
+                if (currentCar == TRUE_VALUE) {
                     printf("#t:boolean\n");
                 } else {
                     printf("#f:boolean\n");
@@ -1,11 +1,14 @@
 #include "value.h"
+#include "talloc.h"
 
 #ifndef _TOKENIZER
 #define _TOKENIZER
 
 // Read all of the input from stdin, and return a linked list consisting of the
-// tokens.
-Value *tokenize();
+// tokens. String and bignum tokens are allocated in literals, or the current
+// context if that is NULL, so that they can go into the parse tree as they are
+// even when the rest of the tokens are freed once it is built.
+Value *tokenize(TallocContext *literals);
 
 // Displays the contents of the linked list as tokens, with type information
 void displayTokens(Value *list);
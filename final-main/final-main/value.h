@@ -1,6 +1,82 @@
 #ifndef _VALUE
 #define _VALUE
 
+#include <stdint.h>
+#include <stdbool.h>
+
+// A Value pointer whose low bit is set is a fixnum, and one whose low bits are
+// 010 is one of the constants defined below; see typeOf.
+#define FIXNUM_TAG 1
+#define CONSTANT_TAG 2
+#define TAG_BITS (FIXNUM_TAG | CONSTANT_TAG)
+
+// Pointers from one Value or Frame to another. Normally they're ordinary
+// pointers. Built with -DCOMPRESSED_REFS, they're 32-bit references instead:
+// offsets, in 8-byte units, into the one heap region that talloc carves every
+// Value and Frame out of, with 0 standing for NULL. That shrinks a Value to 16
+// bytes (a cons cell is its 4-byte type plus two 4-byte references) and a
+// Frame to 8. Read these fields with VALUE_AT/FRAME_AT and write them with REF,
+// which are no-ops in the ordinary build; for cons cells, use car, cdr and
+// setCdr from linkedlist.h. Immediates are stored in a reference as they are,
+// which is why a fixnum only has 31 bits in this build, and why talloc never
+// hands out the first block of the region: references smaller than
+// IMMEDIATE_REFS can't name an object.
+#ifdef COMPRESSED_REFS
+#define REF_SHIFT 3
+#define IMMEDIATE_REFS 8192
+
+typedef uint32_t ValueRef;
+typedef uint32_t FrameRef;
+
+// defined in talloc.c; the start of the heap region
+extern char *heapStart;
+
+static inline void *fromRef(uint32_t ref) {
+    return ref == 0 ? (void *)0 : heapStart + ((unsigned long)ref << REF_SHIFT);
+}
+
+static inline uint32_t toRef(const void *pointer) {
+    uintptr_t bits = (uintptr_t)pointer;
+    if (bits == 0 || (bits & TAG_BITS) != 0) {
+        return (uint32_t)bits;
+    }
+    return (uint32_t)((bits - (uintptr_t)heapStart) >> REF_SHIFT);
+}
+
+static inline struct Value *fromValueRef(uint32_t ref) {
+    if ((ref & FIXNUM_TAG) != 0 || ref < IMMEDIATE_REFS) {
+        // sign-extends a negative fixnum
+        return (struct Value *)(intptr_t)(int32_t)ref;
+    }
+    return (struct Value *)(heapStart + ((uintptr_t)ref << REF_SHIFT));
+}
+
+#define VALUE_AT(ref) fromValueRef(ref)
+#define FRAME_AT(ref) ((struct Frame *)fromRef(ref))
+#define REF(pointer) toRef(pointer)
+
+// lets a Value's double and pointer fields sit at offset 4, so the union is 12 bytes, not 16
+#define PACKED_REFS __attribute__((packed))
+
+// strings shorter than this are kept inside the Value (see struct String)
+#define INLINE_STRING 8
+
+// an odd reference is a fixnum, so anything a reference names has to start on
+// a 16-byte boundary, which leaves a CompactCell no smaller than a Value
+#define COMPACT_CELL __attribute__((aligned(16)))
+#else
+typedef struct Value *ValueRef;
+typedef struct Frame *FrameRef;
+
+#define VALUE_AT(ref) (ref)
+#define FRAME_AT(ref) (ref)
+#define REF(pointer) (pointer)
+#define PACKED_REFS
+
+#define INLINE_STRING 16
+#define COMPACT_CELL
+#endif
+
 typedef enum {
     INT_TYPE, DOUBLE_TYPE, STR_TYPE, CONS_TYPE, NULL_TYPE, PTR_TYPE,
     OPEN_TYPE, CLOSE_TYPE, BOOL_TYPE, SYMBOL_TYPE,
@@ -15,19 +91,180 @@ typedef enum {
     PRIMITIVE_TYPE,
 
     // Type below is new for final portion
-    UNSPECIFIED_TYPE
+    UNSPECIFIED_TYPE,
+
+    // Type below is for integers that don't fit in 64 bits
+    BIGNUM_TYPE,
+
+    VECTOR_TYPE, HASH_TYPE,
+
+    // Types below are vectors of unboxed doubles and 64-bit integers
+    F64VECTOR_TYPE, S64VECTOR_TYPE,
+
+    // Type below is a vector of raw bytes
+    BYTEVECTOR_TYPE,
+
+    // Types below are made by define-record-type: records, the types they
+    // belong to, and the constructors, predicates, accessors and modifiers
+    RECORD_TYPE, RECORD_DESCRIPTOR_TYPE, RECORD_PROCEDURE_TYPE,
+
+    // Types below are only made by the resolver (see resolver.h): references
+    // to local and global variables, and the variables of a new frame
+    LOCAL_REF_TYPE, GLOBAL_REF_TYPE, SCOPE_TYPE,
+
+    // Type below is a special form's keyword, which the resolver puts at the
+    // head of each of its combinations in place of the symbol (see special.h)
+    SPECIAL_FORM_TYPE,
+
+    // Types below only ever appear in the type field of a cell of a CDR-coded
+    // list (see struct CompactCell); typeOf reports them as CONS_TYPE
+    CDR_NEXT_TYPE, CDR_NIL_TYPE
 } valueType;
 
+// The digits of a BIGNUM_TYPE integer's magnitude, in base 2^32 and least
+// significant first, with no leading zeros; the struct and its digits are a
+// payload of the integer (see tallocPayload), like a string's characters.
+struct Bignum {
+    int negative;
+    uint32_t length;
+    uint32_t digits[];
+};
+
+typedef struct Bignum Bignum;
+
+// A VECTOR_TYPE value's items, one after another in a payload of the value
+// (see tallocPayload). A vector can't change length, so its items never have
+// to move.
+struct Vector {
+    uint32_t length;
+    ValueRef items[];
+};
+
+typedef struct Vector Vector;
+
+// The items of an F64VECTOR_TYPE or S64VECTOR_TYPE value, stored unboxed one
+// after another in a payload of the value, where numvector.c's kernels can
+// stream through them.
+struct F64Vector {
+    uint64_t length;
+    double items[];
+};
+
+struct S64Vector {
+    uint64_t length;
+    int64_t items[];
+};
+
+// A BYTEVECTOR_TYPE value's bytes: in a payload of the value, right after this
+// struct, for one the program made, or a read-only mapping of the whole file
+// for one from file->bytevector, which is never copied and is unmapped when the
+// value is freed.
+struct Bytevector {
+    uint64_t length;
+    bool readOnly;
+    uint8_t *bytes;
+};
+
+// A record type, in the arena, where it never moves, so whether a record
+// belongs to it is a matter of comparing pointers. Its name and field names are
+// interned symbol names.
+struct RecordType {
+    char *name;
+    uint32_t fieldCount;
+    char **fieldNames;
+};
+
+typedef struct RecordType RecordType;
+
+// A RECORD_TYPE value's fields, one after another after its type in a payload
+// of the value, like a vector's items. Every field has a fixed index, decided
+// when the type was defined, so getting or setting one is a single load or
+// store.
+struct Record {
+    RecordType *type;
+    ValueRef fields[];
+};
+
+typedef struct Record Record;
+
+// What a RECORD_PROCEDURE_TYPE value does when it is applied. An accessor or
+// modifier knows the index of its field; a constructor knows, for each of its
+// arguments in turn, the index of the field it initializes.
+typedef enum {
+    RECORD_CONSTRUCTOR, RECORD_PREDICATE, RECORD_ACCESSOR, RECORD_MODIFIER
+} recordProcedureKind;
+
+struct RecordProcedure {
+    recordProcedureKind kind;
+    RecordType *type;
+    uint32_t field;
+    uint32_t argCount;
+    uint32_t argFields[];
+};
+
+// One slot of a hash table. hash is EMPTY_SLOT for a slot that has never been
+// used and DELETED_SLOT for one whose entry was deleted; a live entry's hash is
+// always bigger than either.
+#define EMPTY_SLOT 0
+#define DELETED_SLOT 1
+
+struct HashEntry {
+    uint32_t hash;
+    ValueRef key;
+    ValueRef value;
+};
+
+// A HASH_TYPE value's table, freed along with the value like both of its
+// arrays: open addressing with linear probing over a power-of-two array of
+// slots. Growing moves the entries over to a new array a few slots per
+// operation, so while oldEntries isn't NULL, the entries in its slots from
+// migrated on haven't been moved yet, and the old array is freed once they all
+// have been (see hashtable.c).
+struct HashTable {
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t used;
+    struct HashEntry *entries;
+    uint32_t oldCapacity;
+    uint32_t migrated;
+    struct HashEntry *oldEntries;
+};
+
+typedef struct HashTable HashTable;
+
+// The characters of a string too long to keep inside its Value, in a payload
+// of the Value (see tallocPayload) and NUL-terminated, after the string's
+// hash, which stringHash fills in the first time it is asked for (0 means not
+// yet).
+struct StringData {
+    uint32_t hash;
+    char chars[];
+};
+
+// A cell of a CDR-coded list, which is a run of cells one after another in
+// memory with each cdr left implicit: a CDR_NEXT_TYPE cell's cdr is the cell
+// right after it, and a CDR_NIL_TYPE cell's is the empty list. A cell is just
+// a type and a car, laid out like the start of a cons cell's Value so that car
+// can read either, which makes it half the size of a Value (in the ordinary
+// build; see COMPACT_CELL). A run that goes on
+// into another one ends in an ordinary CONS_TYPE cell instead. Since a cell
+// has no room for a cdr of its own, CDR-coded lists can't be changed; the
+// parser builds the parse tree out of them (see staticList in linkedlist.h).
+struct CompactCell {
+    valueType type;
+    ValueRef car;
+} COMPACT_CELL;
+
 struct Value {
     valueType type;
     union {
-        int i;
+        int64_t i;
         double d;
         char *s;
         void *p;
         struct ConsCell {
-            struct Value *car;
-            struct Value *cdr;
+            ValueRef car;
+            ValueRef cdr;
         } c;
         // For purposes of this project a closure is just another type of value,
         // containing everything needed to execute a user-defined function: (1)
@@ -35,36 +272,166 @@ struct Value {
         // (3) a pointer to the environment frame in which the function was
         // created.
         struct Closure {
-            struct Value *paramNames;
-            struct Value *functionCode;
-            struct Frame *frame;
+            ValueRef paramNames;
+            ValueRef functionCode;
+            FrameRef frame;
         } cl;
         
         // A primitive style function; just a pointer to it, with the right
         // signature (pf = primitive function)
         struct Value *(*pf)(struct Value *);
-    };
+
+        struct Bignum *b;
+        struct Vector *vec;
+        struct HashTable *ht;
+        struct F64Vector *f64v;
+        struct S64Vector *s64v;
+        struct Bytevector *bv;
+        struct Record *rec;
+        struct RecordType *rt;
+        struct RecordProcedure *rp;
+
+        // A LOCAL_REF_TYPE value is a reference to the variable in slot slot
+        // of the frame depth frames out from the current one; symbol is the
+        // variable's name, which is looked up by name outside that frame while
+        // the slot is unbound, and used in error messages.
+        struct LocalRef {
+            uint32_t depth;
+            uint32_t slot;
+            ValueRef symbol;
+        } lr;
+
+        // A GLOBAL_REF_TYPE value points straight at its global variable's
+        // cell, which never moves and which define and set! update in place,
+        // so it never has to look the variable up or check that it's still
+        // the right cell.
+        struct GlobalCell *global;
+
+        // A SPECIAL_FORM_TYPE value points at the registered special form
+        // whose keyword it stands for.
+        struct SpecialForm *sf;
+
+        // A SCOPE_TYPE value lists the variables of the frame a resolved
+        // lambda, let or letrec creates, by slot: first the count that its
+        // arguments or bindings initialize, then the ones its body defines.
+        struct Scope {
+            uint32_t initialized;
+            uint32_t size;
+            ValueRef names;
+        } sc;
+
+        // A string knows its length, so nothing has to count its characters,
+        // and one shorter than INLINE_STRING keeps them (NUL-terminated) in
+        // the Value itself rather than in a StringData. Read them with
+        // stringChars, which knows which is which.
+        struct String {
+            uint32_t length;
+            union {
+                struct StringData *data;
+                char small[INLINE_STRING];
+            };
+        } PACKED_REFS str;
+    } PACKED_REFS;
 };
 
 typedef struct Value Value;
 
 
-// A frame is a linked list of bindings, and a pointer to another frame.  A
-// binding is a variable name (represented as a string), and a pointer to the
-// Value it is bound to. I'm just going to put these in a flat list, with every
-// other element being a symbol, and the following element being the value. I
-// could do this via yet another data structure, but I think this will
-// ultimately take less coding. It also will require less modification of
-// existing code.
-
+// A frame is an array of slots holding the values of a lambda's, let's or
+// letrec's variables, in the order the resolver gave them (see resolver.h),
+// and a pointer to the frame around it. scope is the static SCOPE_TYPE value
+// naming the slots, which says how many there are; a slot is NULL while its
+// variable is unbound. The global frame has no scope and no slots, since the
+// global variables are in the global environment (see global.h).
 struct Frame {
-    struct Value *bindings;
-    struct Frame *parent;
+    FrameRef parent;
+    ValueRef scope;
+    ValueRef slots[];
 };
 
 typedef struct Frame Frame;
 
+// The size in bytes of a frame with the given number of slots, and the number
+// of slots a frame has.
+#define FRAME_BYTES(slots) (sizeof(struct Frame) + (slots) * sizeof(ValueRef))
+#define FRAME_SLOTS(frame) ((frame) -> scope ? VALUE_AT((frame) -> scope) -> sc.size : 0)
+
+// A variable in the global environment (see global.h). Global cells live
+// outside the heap, so value is an ordinary pointer, and NULL while the
+// variable is unbound.
+typedef struct GlobalCell {
+    char *name;
+    Value *value;
+} GlobalCell;
+
+// A special form (see special.h): its keyword's interned name, and the
+// function that evaluates its combinations, given their unevaluated arguments
+// and the frame they're in.
+typedef Value *(*SpecialFormFunction)(Value *args, Frame *frame);
+
+typedef struct SpecialForm {
+    char *name;
+    SpecialFormFunction evaluate;
+} SpecialForm;
+
+
+// Fixnums, booleans, the empty list and the void and unspecified markers are
+// immediates: the Value pointer itself carries them and nothing is allocated.
+// A fixnum is its integer shifted left one bit with FIXNUM_TAG set; integers
+// too big for that, but still within 64 bits, are ordinary INT_TYPE Values on
+// the heap instead (see makeInt in linkedlist.h), and bigger ones BIGNUM_TYPE.
+// Since an immediate has nothing to point at, read a Value's type with typeOf
+// and an integer with intOf, rather than through the pointer.
+#define IMMEDIATE(index) ((Value *)(uintptr_t)(((index) << 3) | CONSTANT_TAG))
+#define FALSE_VALUE IMMEDIATE(0)
+#define TRUE_VALUE IMMEDIATE(1)
+#define NULL_VALUE IMMEDIATE(2)
+#define VOID_VALUE IMMEDIATE(3)
+#define UNSPECIFIED_VALUE IMMEDIATE(4)
+
+#ifdef COMPRESSED_REFS
+#define FIXNUM_MIN (INT32_MIN / 2)
+#define FIXNUM_MAX (INT32_MAX / 2)
+#else
+#define FIXNUM_MIN (INTPTR_MIN / 2)
+#define FIXNUM_MAX (INTPTR_MAX / 2)
+#endif
+
+static inline int isImmediate(const Value *value) {
+    return ((uintptr_t)value & TAG_BITS) != 0;
+}
+
+static inline valueType typeOf(const Value *value) {
+    static const valueType constantTypes[] = {BOOL_TYPE, BOOL_TYPE, NULL_TYPE, VOID_TYPE, UNSPECIFIED_TYPE};
+    uintptr_t bits = (uintptr_t)value;
+    if ((bits & FIXNUM_TAG) != 0) {
+        return INT_TYPE;
+    }
+    if ((bits & CONSTANT_TAG) != 0) {
+        return constantTypes[bits >> 3];
+    }
+    valueType type = value -> type;
+    return type == CDR_NEXT_TYPE || type == CDR_NIL_TYPE ? CONS_TYPE : type;
+}
+
+static inline int64_t intOf(const Value *value) {
+    if (((uintptr_t)value & FIXNUM_TAG) != 0) {
+        return (intptr_t)value >> 1;
+    }
+    return value -> i;
+}
 
+static inline Value *fixnum(intptr_t number) {
+    return (Value *)(((uintptr_t)number << 1) | FIXNUM_TAG);
+}
 
+// A small string's characters move with its Value when the collector copies
+// it, so don't hold on to this pointer across a safe point.
+static inline char *stringChars(Value *string) {
+    if (string -> str.length < INLINE_STRING) {
+        return string -> str.small;
+    }
+    return string -> str.data -> chars;
+}
 
 #endif